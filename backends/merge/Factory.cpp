@@ -20,6 +20,7 @@
 
 #include "Factory.h"
 
+#include "Merge.h"
 #include "None.h"
 #include "TextCsv.h"
 #include "TextCsvKeys.h"
@@ -42,6 +43,7 @@ namespace glabels
 		QMap<QString,Factory::BackendEntry> Factory::mBackendIdMap;
 		QMap<QString,Factory::BackendEntry> Factory::mBackendNameMap;
 		QStringList Factory::mNameList;
+		bool Factory::mStreaming = false;
 
 
 		///
@@ -117,13 +119,27 @@ namespace glabels
 			QMap<QString,BackendEntry>::iterator iBackend = mBackendIdMap.find( id );
 			if ( iBackend != mBackendIdMap.end() )
 			{
-				return iBackend->create();
+				Merge* merge = iBackend->create();
+				merge->setStreaming( mStreaming );
+				return merge;
 			}
 	
 			return None::create();
 		}
 
 
+		///
+		/// Set streaming mode of subsequently created Merge objects
+		///
+		/// Streamed sources are indexed rather than read into memory, and their
+		/// records are read on demand.  See Merge::setStreaming().
+		///
+		void Factory::setStreaming( bool streaming )
+		{
+			mStreaming = streaming;
+		}
+
+
 		///
 		/// Get name list
 		///
@@ -66,6 +66,8 @@ namespace glabels
 	
 			static Merge* createMerge( const QString& id );
 
+			static void setStreaming( bool streaming );
+
 			static QStringList nameList();
 			static QString idToName( const QString& id );
 			static QString nameToId( const QString& name );
@@ -101,6 +103,8 @@ namespace glabels
 			static QMap<QString,BackendEntry> mBackendNameMap;
 		
 			static QStringList mNameList;
+
+			static bool mStreaming;
 		};
 
 	}
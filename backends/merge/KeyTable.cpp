@@ -0,0 +1,104 @@
+/*  Merge/KeyTable.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KeyTable.h"
+
+#include <QAtomicInt>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			QAtomicInt nextSerial( 1 );
+		}
+
+
+		///
+		/// Constructor
+		///
+		KeyTable::KeyTable() : mSerial( nextSerial.fetchAndAddRelaxed( 1 ) )
+		{
+		}
+
+
+		///
+		/// Get serial number
+		///
+		/// Uniquely identifies this table, so that column indices cached by users
+		/// of the table can be validated.
+		///
+		int KeyTable::serial() const
+		{
+			return mSerial;
+		}
+
+
+		///
+		/// Get number of columns
+		///
+		int KeyTable::size() const
+		{
+			return mKeys.size();
+		}
+
+
+		///
+		/// Get key of column
+		///
+		QString KeyTable::key( int iColumn ) const
+		{
+			return mKeys.value( iColumn );
+		}
+
+
+		///
+		/// Lookup column of key
+		///
+		/// Returns -1 if key is unknown.  If a key appears more than once, the
+		/// last column wins.
+		///
+		int KeyTable::column( const QString& key ) const
+		{
+			return mColumns.value( key, -1 );
+		}
+
+
+		///
+		/// Append column for key
+		///
+		int KeyTable::appendKey( const QString& key )
+		{
+			int iColumn = mKeys.size();
+
+			mKeys << key;
+			mColumns.insert( key, iColumn );
+
+			return iColumn;
+		}
+
+	} // namespace merge
+} // namespace glabels
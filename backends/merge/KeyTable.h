@@ -0,0 +1,83 @@
+/*  Merge/KeyTable.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef merge_KeyTable_h
+#define merge_KeyTable_h
+
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+
+namespace glabels
+{
+	namespace merge
+	{
+
+		///
+		/// Merge Key Table
+		///
+		/// Maps field keys to column indices.  A single table is shared by all
+		/// records of a merge source.  Columns are only ever appended, so a column
+		/// index, once resolved, stays valid for the life of the table.
+		///
+		class KeyTable
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			KeyTable();
+
+
+			/////////////////////////////////
+			// Properties
+			/////////////////////////////////
+		public:
+			int serial() const;
+			int size() const;
+			QString key( int iColumn ) const;
+
+
+			/////////////////////////////////
+			// Methods
+			/////////////////////////////////
+		public:
+			int column( const QString& key ) const;
+			int appendKey( const QString& key );
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			int                mSerial;
+			QStringList        mKeys;
+			QHash<QString,int> mColumns;
+
+		};
+
+	}
+}
+
+
+#endif // merge_KeyTable_h
@@ -31,7 +31,18 @@ namespace glabels
 		///
 		/// Constructor
 		///
-		Merge::Merge( const Merge* merge ) : mId(merge->mId), mSource(merge->mSource)
+		Merge::Merge() : mStreaming(false), mIndexed(false)
+		{
+		}
+
+
+		///
+		/// Constructor
+		///
+		Merge::Merge( const Merge* merge )
+			: mId(merge->mId), mSource(merge->mSource),
+			  mStreaming(merge->mStreaming), mIndexed(merge->mIndexed),
+			  mRowSelected(merge->mRowSelected), mSelectedRows(merge->mSelectedRows)
 		{
 			foreach ( Record* record, merge->mRecordList )
 			{
@@ -84,8 +95,25 @@ namespace glabels
 				delete record;
 			}
 			mRecordList.clear();
+			mIndexed = false;
+			mRowSelected.clear();
+			mSelectedRows.clear();
 
 			open();
+			if ( mStreaming )
+			{
+				int nRows = indexRecords();
+				if ( nRows >= 0 )
+				{
+					// Source is left open, records are read on demand
+					mIndexed = true;
+					mRowSelected.fill( true, nRows );
+					updateSelectedRows();
+
+					emit sourceChanged();
+					return;
+				}
+			}
 			for ( Record* record = readNextRecord(); record != nullptr; record = readNextRecord() )
 			{
 				mRecordList.append( record );
@@ -96,6 +124,38 @@ namespace glabels
 		}
 
 
+		///
+		/// Is source being streamed?
+		///
+		/// A streamed source is only indexed when set.  Its records are not held
+		/// in recordList(), but are read on demand using readSelectedRecord().
+		///
+		bool Merge::isStreaming() const
+		{
+			return mIndexed;
+		}
+
+
+		///
+		/// Set streaming mode
+		///
+		/// Takes effect on the next setSource(), or immediately if a source is
+		/// already set.  Backends that cannot stream fall back to reading all
+		/// records up front.
+		///
+		void Merge::setStreaming( bool streaming )
+		{
+			if ( streaming != mStreaming )
+			{
+				mStreaming = streaming;
+				if ( !mSource.isEmpty() )
+				{
+					setSource( QString( mSource ) );
+				}
+			}
+		}
+
+
 		///
 		/// Get record list
 		///
@@ -130,7 +190,16 @@ namespace glabels
 		///
 		void Merge::setSelected( int i, bool state )
 		{
-			if ( (i >= 0) && (i < mRecordList.size()) )
+			if ( mIndexed )
+			{
+				if ( (i >= 0) && (i < mRowSelected.size()) )
+				{
+					mRowSelected.setBit( i, state );
+					updateSelectedRows();
+					emit selectionChanged();
+				}
+			}
+			else if ( (i >= 0) && (i < mRecordList.size()) )
 			{
 				mRecordList[i]->setSelected( state );
 				emit selectionChanged();
@@ -147,6 +216,8 @@ namespace glabels
 			{
 				record->setSelected( true );
 			}
+			mRowSelected.fill( true );
+			updateSelectedRows();
 			emit selectionChanged();
 		}
 
@@ -160,6 +231,8 @@ namespace glabels
 			{
 				record->setSelected( false );
 			}
+			mRowSelected.fill( false );
+			updateSelectedRows();
 			emit selectionChanged();
 		}
 
@@ -169,6 +242,11 @@ namespace glabels
 		///
 		int Merge::nSelectedRecords() const
 		{
+			if ( mIndexed )
+			{
+				return mSelectedRows.size();
+			}
+
 			int count = 0;
 
 			foreach ( Record* record, mRecordList )
@@ -201,5 +279,58 @@ namespace glabels
 			return list;
 		}
 
+
+		///
+		/// Read i'th selected record of a streamed source
+		///
+		void Merge::readSelectedRecord( int iSelected, Record& record ) const
+		{
+			if ( mIndexed && (iSelected >= 0) && (iSelected < mSelectedRows.size()) )
+			{
+				readRecord( mSelectedRows[iSelected], record );
+			}
+			else
+			{
+				record.clear();
+			}
+		}
+
+
+		///
+		/// Index records for streaming (default: streaming not supported)
+		///
+		/// Called after open().  Returns the number of records in the source, or
+		/// -1 if the backend cannot read records on demand.
+		///
+		int Merge::indexRecords()
+		{
+			return -1;
+		}
+
+
+		///
+		/// Read i'th record of an indexed source (default: empty record)
+		///
+		void Merge::readRecord( int iRecord, Record& record ) const
+		{
+			record.clear();
+		}
+
+
+		///
+		/// Rebuild list of selected rows of an indexed source
+		///
+		void Merge::updateSelectedRows()
+		{
+			mSelectedRows.clear();
+			for ( int i = 0; i < mRowSelected.size(); i++ )
+			{
+				if ( mRowSelected.testBit( i ) )
+				{
+					mSelectedRows.append( i );
+				}
+			}
+		}
+
 	} // namespace merge
 } // namespace glabels
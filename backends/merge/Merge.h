@@ -22,10 +22,12 @@
 #define merge_Merge_h
 
 
+#include <QBitArray>
 #include <QObject>
 #include <QString>
 #include <QStringList>
 #include <QList>
+#include <QVector>
 
 
 namespace glabels
@@ -49,7 +51,7 @@ namespace glabels
 			// Life Cycle
 			/////////////////////////////////
 		protected:
-			Merge() = default;
+			Merge();
 			Merge( const Merge* merge );
 		public:
 			~Merge() override;
@@ -68,6 +70,8 @@ namespace glabels
 			QString id() const;
 			QString source() const;
 			void setSource( const QString& source );
+			bool isStreaming() const;
+			void setStreaming( bool streaming );
 
 			const QList<Record*>& recordList( ) const;
 
@@ -84,6 +88,7 @@ namespace glabels
 	
 			int nSelectedRecords() const;
 			const QList<Record*> selectedRecords() const;
+			void readSelectedRecord( int iSelected, Record& record ) const;
 
 
 			/////////////////////////////////
@@ -96,6 +101,15 @@ namespace glabels
 			virtual void open() = 0;
 			virtual void close() = 0;
 			virtual Record* readNextRecord() = 0;
+			virtual int indexRecords();
+			virtual void readRecord( int iRecord, Record& record ) const;
+
+
+			/////////////////////////////////
+			// Private methods
+			/////////////////////////////////
+		private:
+			void updateSelectedRows();
 		
 
 			/////////////////////////////////
@@ -114,6 +128,11 @@ namespace glabels
 		private:
 			QString             mSource;
 			QList<Record*>      mRecordList;
+
+			bool                mStreaming;
+			bool                mIndexed;
+			QBitArray           mRowSelected;
+			QVector<int>        mSelectedRows;
 		};
 
 	}
@@ -29,7 +29,16 @@ namespace glabels
 		///
 		/// Constructor
 		///
-		Record::Record() : mSelected( true )
+		Record::Record() : mKeyTable( new KeyTable() ), mSelected( true )
+		{
+		}
+
+
+		///
+		/// Constructor
+		///
+		Record::Record( const QSharedPointer<KeyTable>& keyTable )
+			: mKeyTable( keyTable ), mSelected( true )
 		{
 		}
 
@@ -38,7 +47,7 @@ namespace glabels
 		/// Constructor
 		///
 		Record::Record( const Record* record )
-			: QMap<QString,QString>(*record), mSelected(record->mSelected)
+			: mKeyTable(record->mKeyTable), mValues(record->mValues), mSelected(record->mSelected)
 		{
 		}
 
@@ -52,6 +61,43 @@ namespace glabels
 		}
 
 
+		///
+		/// Is equal to other record?  (Same keys and values)
+		///
+		bool Record::operator==( const Record& other ) const
+		{
+			return toMap() == other.toMap();
+		}
+
+
+		///
+		/// Is not equal to other record?
+		///
+		bool Record::operator!=( const Record& other ) const
+		{
+			return !( *this == other );
+		}
+
+
+		///
+		/// Access value of key, adding key if needed
+		///
+		QString& Record::operator[]( const QString& key )
+		{
+			int iColumn = mKeyTable->column( key );
+			if ( iColumn < 0 )
+			{
+				iColumn = mKeyTable->appendKey( key );
+			}
+			if ( !hasValueAt( iColumn ) )
+			{
+				setValueAt( iColumn, "" );
+			}
+
+			return mValues[iColumn];
+		}
+
+
 		///
 		/// Is record selected?
 		///
@@ -69,5 +115,102 @@ namespace glabels
 			mSelected = value;
 		}
 
+
+		///
+		/// Get key table
+		///
+		const KeyTable* Record::keyTable() const
+		{
+			return mKeyTable.data();
+		}
+
+
+		///
+		/// Does record contain key?
+		///
+		bool Record::contains( const QString& key ) const
+		{
+			return hasValueAt( mKeyTable->column( key ) );
+		}
+
+
+		///
+		/// Get value of key (empty if not present)
+		///
+		QString Record::value( const QString& key ) const
+		{
+			return valueAt( mKeyTable->column( key ) );
+		}
+
+
+		///
+		/// Clear all values
+		///
+		void Record::clear()
+		{
+			mValues.clear();
+		}
+
+
+		///
+		/// Convert to key/value map
+		///
+		QMap<QString,QString> Record::toMap() const
+		{
+			QMap<QString,QString> map;
+
+			for ( int i = 0; i < mValues.size(); i++ )
+			{
+				if ( hasValueAt( i ) )
+				{
+					map.insert( mKeyTable->key( i ), mValues[i] );
+				}
+			}
+
+			return map;
+		}
+
+
+		///
+		/// Get column of key (-1 if unknown)
+		///
+		int Record::column( const QString& key ) const
+		{
+			return mKeyTable->column( key );
+		}
+
+
+		///
+		/// Does record have a value in column?
+		///
+		bool Record::hasValueAt( int iColumn ) const
+		{
+			return (iColumn >= 0) && (iColumn < mValues.size()) && !mValues[iColumn].isNull();
+		}
+
+
+		///
+		/// Get value in column (empty if not present)
+		///
+		QString Record::valueAt( int iColumn ) const
+		{
+			return hasValueAt( iColumn ) ? mValues[iColumn] : QString();
+		}
+
+
+		///
+		/// Set value in column
+		///
+		void Record::setValueAt( int iColumn, const QString& value )
+		{
+			if ( iColumn >= mValues.size() )
+			{
+				mValues.resize( iColumn + 1 );
+			}
+
+			// Null marks a missing value, so store empty values as non-null
+			mValues[iColumn] = value.isNull() ? QString( "" ) : value;
+		}
+
 	} // namespace merge
 } // namespace glabels
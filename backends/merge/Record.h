@@ -22,8 +22,12 @@
 #define merge_Record_h
 
 
-#include <QString>
+#include "KeyTable.h"
+
 #include <QMap>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
 
 
 namespace glabels
@@ -34,7 +38,11 @@ namespace glabels
 		///
 		/// Merge Record
 		///
-		class Record : public QMap<QString,QString>
+		/// Values are stored by column, as defined by a KeyTable shared with the
+		/// other records of the same merge source.  A value that is not present
+		/// is stored as a null string.
+		///
+		class Record
 		{
 
 			/////////////////////////////////
@@ -42,6 +50,7 @@ namespace glabels
 			/////////////////////////////////
 		public:
 			Record();
+			Record( const QSharedPointer<KeyTable>& keyTable );
 			Record( const Record* record );
 
 
@@ -51,6 +60,15 @@ namespace glabels
 			Record* clone() const;
 
 
+			/////////////////////////////////
+			// Operators
+			/////////////////////////////////
+		public:
+			bool operator==( const Record& other ) const;
+			bool operator!=( const Record& other ) const;
+			QString& operator[]( const QString& key );
+
+
 			/////////////////////////////////
 			// Properties
 			/////////////////////////////////
@@ -58,12 +76,36 @@ namespace glabels
 			bool isSelected() const;
 			void setSelected( bool value );
 
+			const KeyTable* keyTable() const;
+
+
+			/////////////////////////////////
+			// Access by key
+			/////////////////////////////////
+		public:
+			bool contains( const QString& key ) const;
+			QString value( const QString& key ) const;
+			void clear();
+			QMap<QString,QString> toMap() const;
+
+
+			/////////////////////////////////
+			// Access by column
+			/////////////////////////////////
+		public:
+			int column( const QString& key ) const;
+			bool hasValueAt( int iColumn ) const;
+			QString valueAt( int iColumn ) const;
+			void setValueAt( int iColumn, const QString& value );
+
 
 			/////////////////////////////////
 			// Private data
 			/////////////////////////////////
 		private:
-			bool                  mSelected;
+			QSharedPointer<KeyTable> mKeyTable;
+			QVector<QString>         mValues;
+			bool                     mSelected;
 
 		};
 
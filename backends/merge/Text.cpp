@@ -24,17 +24,84 @@
 
 #include <QtDebug>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MERGE_TEXT_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 
 namespace glabels
 {
 	namespace merge
 	{
 
+		//
+		// Private
+		//
+		namespace
+		{
+			///
+			/// Count field, and add it to list of fields if not null
+			///
+			void addField( QStringList* fields, int& nFields, const QByteArray& field )
+			{
+				if ( fields )
+				{
+					*fields << QString( field );
+				}
+				nFields++;
+			}
+
+
+			///
+			/// Find first occurrence of any of c1..c4 in [p,end)
+			///
+			/// Scans 16 bytes at a time where SSE2 is available.  Returns end if
+			/// none of the characters are found.
+			///
+			const char* findAnyOf( const char* p, const char* end, char c1, char c2, char c3, char c4 )
+			{
+#if MERGE_TEXT_USE_SSE2
+				const __m128i v1 = _mm_set1_epi8( c1 );
+				const __m128i v2 = _mm_set1_epi8( c2 );
+				const __m128i v3 = _mm_set1_epi8( c3 );
+				const __m128i v4 = _mm_set1_epi8( c4 );
+
+				while ( (end - p) >= 16 )
+				{
+					__m128i chunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+					__m128i match = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( chunk, v1 ),
+					                                            _mm_cmpeq_epi8( chunk, v2 ) ),
+					                              _mm_or_si128( _mm_cmpeq_epi8( chunk, v3 ),
+					                                            _mm_cmpeq_epi8( chunk, v4 ) ) );
+					unsigned int mask = _mm_movemask_epi8( match );
+					if ( mask )
+					{
+						while ( !(mask & 1) )
+						{
+							mask >>= 1;
+							p++;
+						}
+						return p;
+					}
+					p += 16;
+				}
+#endif
+				while ( (p < end) && (*p != c1) && (*p != c2) && (*p != c3) && (*p != c4) )
+				{
+					p++;
+				}
+				return p;
+			}
+		}
+
+
 		///
 		/// Constructor
 		///
 		Text::Text( QChar delimiter, bool line1HasKeys )
-			: mDelimeter(delimiter), mLine1HasKeys(line1HasKeys), mNFieldsMax(0)
+			: mDelimeter(delimiter), mLine1HasKeys(line1HasKeys),
+			  mData(nullptr), mSize(0), mPos(0), mNFieldsMax(0)
 		{
 		}
 
@@ -45,8 +112,15 @@ namespace glabels
 		Text::Text( const Text* merge )
 			: Merge( merge ),
 			  mDelimeter(merge->mDelimeter), mLine1HasKeys(merge->mLine1HasKeys),
-			  mKeys(merge->mKeys), mNFieldsMax(merge->mNFieldsMax)
+			  mData(nullptr), mSize(0), mPos(0),
+			  mKeys(merge->mKeys), mNFieldsMax(merge->mNFieldsMax),
+			  mKeyTable(merge->mKeyTable), mRowOffsets(merge->mRowOffsets)
 		{
+			if ( isStreaming() )
+			{
+				// Records are read on demand, so our copy needs its own view of the source
+				mapSource();
+			}
 		}
 
 
@@ -78,11 +152,14 @@ namespace glabels
 		///
 		void Text::open()
 		{
+			close();
+
 			mKeys.clear();
 			mNFieldsMax = 0;
+			mKeyTable = QSharedPointer<KeyTable>( new KeyTable() );
+			mRowOffsets.clear();
 
-			mFile.setFileName( source() );
-			if (mFile.open( QIODevice::ReadOnly|QIODevice::Text ))
+			if ( mapSource() )
 			{
 				if ( mLine1HasKeys )
 				{
@@ -105,13 +182,46 @@ namespace glabels
 		///
 		void Text::close()
 		{
+			mData = nullptr;
+			mSize = 0;
+			mPos  = 0;
+			mBuffer.clear();
+
 			if ( mFile.isOpen() )
 			{
-				mFile.close();
+				mFile.close(); // Also unmaps file
 			}
 		}
 
 
+		///
+		/// Map source into memory
+		///
+		/// Falls back to reading the whole source into a buffer, if the source
+		/// cannot be mapped (e.g. it is empty or is not a regular file).
+		///
+		bool Text::mapSource()
+		{
+			mFile.setFileName( source() );
+			if ( !mFile.open( QIODevice::ReadOnly ) )
+			{
+				return false;
+			}
+
+			mSize = mFile.size();
+			mData = (mSize > 0) ? reinterpret_cast<const char*>( mFile.map( 0, mSize ) ) : nullptr;
+			if ( !mData )
+			{
+				mBuffer = mFile.readAll();
+				mData   = mBuffer.constData();
+				mSize   = mBuffer.size();
+			}
+			mPos = 0;
+
+			return true;
+		}
+
+
 		///
 		/// Read next record
 		///
@@ -120,12 +230,15 @@ namespace glabels
 			QStringList values = parseLine();
 			if ( !values.isEmpty() )
 			{
-				auto* record = new Record();
+				extendKeyTable( values.size() );
+
+				// Keys are appended in field order, so field index is column index
+				auto* record = new Record( mKeyTable );
 
 				int iField = 0;
 				foreach ( QString value, values )
 				{
-					(*record)[ keyFromIndex(iField) ] = value;
+					record->setValueAt( iField, value );
 					iField++;
 				}
 				mNFieldsMax = std::max( mNFieldsMax, iField );
@@ -136,6 +249,71 @@ namespace glabels
 		}
 
 
+		///
+		/// Index records for streaming
+		///
+		/// Records are only scanned for their starting offsets and field counts;
+		/// no field values are created.
+		///
+		int Text::indexRecords()
+		{
+			for (;;)
+			{
+				qint64 start = mPos;
+
+				int nFields = scanLine( mPos, nullptr );
+				if ( nFields == 0 )
+				{
+					break;
+				}
+
+				mRowOffsets.append( start );
+				mNFieldsMax = std::max( mNFieldsMax, nFields );
+			}
+
+			// Complete the key table up front, so that reading records never modifies it
+			extendKeyTable( mNFieldsMax );
+
+			return mRowOffsets.size();
+		}
+
+
+		///
+		/// Read i'th record of indexed source
+		///
+		void Text::readRecord( int iRecord, Record& record ) const
+		{
+			record = Record( mKeyTable );
+
+			if ( (iRecord >= 0) && (iRecord < mRowOffsets.size()) )
+			{
+				qint64 pos = mRowOffsets[iRecord];
+
+				QStringList values;
+				scanLine( pos, &values );
+
+				int iField = 0;
+				foreach ( const QString& value, values )
+				{
+					record.setValueAt( iField, value );
+					iField++;
+				}
+			}
+		}
+
+
+		///
+		/// Extend key table to cover given number of fields
+		///
+		void Text::extendKeyTable( int nFields )
+		{
+			while ( mKeyTable->size() < nFields )
+			{
+				mKeyTable->appendKey( keyFromIndex( mKeyTable->size() ) );
+			}
+		}
+
+
 		///
 		/// Key from field index
 		///
@@ -172,6 +350,23 @@ namespace glabels
 		QStringList Text::parseLine()
 		{
 			QStringList fields;
+			scanLine( mPos, &fields );
+
+			return fields;
+		}
+
+
+		///
+		/// Scan line starting at pos, leaving pos at the start of the next line.
+		///
+		/// Fields are appended to fields, unless it is null.  Carriage returns are
+		/// dropped, just as they would be reading the source in text mode.
+		///
+		/// Returns number of fields.  Returns 0 when done.
+		///
+		int Text::scanLine( qint64& pos, QStringList* fields ) const
+		{
+			int nFields = 0;
 	
 			enum State
 			{
@@ -179,12 +374,38 @@ namespace glabels
 			} state = DELIM;
 
 			QByteArray field;
+			field.reserve( 256 ); // Also keeps capacity when resized to 0
+
+			const char  delim = mDelimeter.toLatin1();
+			const char* end   = mData + mSize;
 	
 			while ( state != DONE )
 			{
-				char c;
-				if ( mFile.getChar( &c ) )
+				//
+				// Fast path: copy runs of ordinary characters in bulk.  Only the
+				// characters that can change the state are left for the state
+				// machine below.
+				//
+				if ( (state == SIMPLE) || (state == QUOTED) )
+				{
+					const char* p = mData + pos;
+					const char* q = (state == SIMPLE) ? findAnyOf( p, end, '\n', '\r', '\\', delim )
+					                                  : findAnyOf( p, end, '"', '\r', '\\', '"' );
+					if ( fields )
+					{
+						field.append( p, int(q - p) );
+					}
+					pos += q - p;
+				}
+
+				if ( pos < mSize )
 				{
+					char c = mData[pos++];
+					if ( c == '\r' )
+					{
+						continue;
+					}
+
 					switch (state)
 					{
 
@@ -193,7 +414,7 @@ namespace glabels
 						{
 						case '\n':
 							/* last field is empty. */
-							fields << "";
+							addField( fields, nFields, QByteArray("") );
 							state = DONE;
 							break;
 						case '\r':
@@ -212,7 +433,7 @@ namespace glabels
 							if ( c == mDelimeter )
 							{
 								/* field is empty. */
-								fields << "";
+								addField( fields, nFields, QByteArray("") );
 								state = DELIM;
 							}
 							else
@@ -248,7 +469,7 @@ namespace glabels
 						{
 						case '\n':
 							/* line ended after quoted item */
-							fields << QString( field );
+							addField( fields, nFields, field );
 							state = DONE;
 							break;
 						case '"':
@@ -264,8 +485,8 @@ namespace glabels
 							if ( c == mDelimeter )
 							{
 								/* end of field. */
-								fields << QString( field );
-								field.clear();
+								addField( fields, nFields, field );
+								field.resize( 0 );
 								state = DELIM;
 							}
 							else
@@ -304,7 +525,7 @@ namespace glabels
 						{
 						case '\n':
 							/* line ended */
-							fields << QString( field );
+							addField( fields, nFields, field );
 							state = DONE;
 							break;
 						case '\r':
@@ -319,8 +540,8 @@ namespace glabels
 							if ( c == mDelimeter )
 							{
 								/* end of field. */
-								fields << QString( field );
-								field.clear();
+								addField( fields, nFields, field );
+								field.resize( 0 );
 								state = DELIM;
 							}
 							else
@@ -372,27 +593,27 @@ namespace glabels
 
 					case QUOTED:
 						/* File ended midway through quoted item. Truncate field. */
-						fields << QString( field );
+						addField( fields, nFields, field );
 						break;
 
 					case QUOTED_QUOTE1:
 						/* File ended after quoted item. */
-						fields << QString( field );
+						addField( fields, nFields, field );
 						break;
 
 					case QUOTED_ESCAPED:
 						/* File ended midway through quoted item. Truncate field. */
-						fields << QString( field );
+						addField( fields, nFields, field );
 						break;
 
 					case SIMPLE:
 						/* File ended after simple item. */
-						fields << QString( field );
+						addField( fields, nFields, field );
 						break;
 
 					case SIMPLE_ESCAPED:
 						/* File ended midway through escaped item. */
-						fields << QString( field );
+						addField( fields, nFields, field );
 						break;
 
 					default:
@@ -405,7 +626,7 @@ namespace glabels
 			}
 	
 
-			return fields;
+			return nFields;
 		}
 
 	} // namespace merge
@@ -21,9 +21,13 @@
 #ifndef merge_Text_h
 #define merge_Text_h
 
+#include "KeyTable.h"
 #include "Merge.h"
 
+#include <QByteArray>
 #include <QFile>
+#include <QSharedPointer>
+#include <QVector>
 
 
 namespace glabels
@@ -56,13 +60,18 @@ namespace glabels
 			void open() override;
 			void close() override;
 			Record* readNextRecord() override;
+			int indexRecords() override;
+			void readRecord( int iRecord, Record& record ) const override;
 
 
 			/////////////////////////////////
 			// Private methods
 			/////////////////////////////////
+			bool mapSource();
 			QString keyFromIndex( int iField ) const;
 			QStringList parseLine();
+			int scanLine( qint64& pos, QStringList* fields ) const;
+			void extendKeyTable( int nFields );
 	
 
 			/////////////////////////////////
@@ -73,8 +82,17 @@ namespace glabels
 			bool  mLine1HasKeys;
 
 			QFile          mFile;
+			QByteArray     mBuffer;
+			const char*    mData;
+			qint64         mSize;
+			qint64         mPos;
+
 			QStringList    mKeys;
 			int            mNFieldsMax;
+
+			QSharedPointer<KeyTable> mKeyTable;
+
+			QVector<qint64> mRowOffsets;
 		};
 
 	}
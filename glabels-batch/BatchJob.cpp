@@ -0,0 +1,269 @@
+/*  BatchJob.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BatchJob.h"
+
+#include "model/Model.h"
+#include "model/PageRenderer.h"
+#include "model/XmlLabelParser.h"
+
+#include "merge/Factory.h"
+
+#include <QCoreApplication>
+#include <QPrinter>
+#include <QPrinterInfo>
+#include <QtDebug>
+
+
+namespace glabels
+{
+
+	//
+	// Private
+	//
+	namespace
+	{
+
+#if defined(Q_OS_WIN)
+		const QString STDOUT_FILENAME = "CON:";
+#elif defined(Q_OS_LINUX)
+		const QString STDOUT_FILENAME = "/dev/stdout";
+#else
+		const QString STDOUT_FILENAME = "/dev/stdout";
+#endif
+
+	}
+
+
+	///
+	/// Constructor
+	///
+	BatchJob::BatchJob()
+		: mNCopies(1), mFirstLabel(1), mOutlines(false), mCropMarks(false), mReverse(false),
+		  mNJobs(1), mLabelCache(false), mStreamMerge(false)
+	{
+		// empty
+	}
+
+
+	///
+	/// Get project filename
+	///
+	QString BatchJob::filename() const
+	{
+		return mFilename;
+	}
+
+
+	///
+	/// Get output filename (empty if not set)
+	///
+	QString BatchJob::outputFilename() const
+	{
+		return mOutputFilename;
+	}
+
+
+	///
+	/// Set options from command line
+	///
+	/// Counts ("copies", "first" and "jobs") must be 1 or more.  In server mode
+	/// these become the defaults of every job.
+	///
+	bool BatchJob::setOptions( const QCommandLineParser& parser, QString& errorString )
+	{
+		if ( parser.positionalArguments().size() == 1 )
+		{
+			mFilename = parser.positionalArguments().constFirst();
+		}
+		if ( parser.isSet( "printer" ) )
+		{
+			mPrinterName = parser.value( "printer" );
+		}
+		if ( parser.isSet( "output" ) )
+		{
+			mOutputFilename = parser.value( "output" );
+		}
+		mNCopies     = parser.value( "copies" ).toInt();
+		mFirstLabel  = parser.value( "first" ).toInt();
+		mOutlines    = parser.isSet( "outlines" );
+		mCropMarks   = parser.isSet( "crop-marks" );
+		mReverse     = parser.isSet( "reverse" );
+		mNJobs       = parser.value( "jobs" ).toInt();
+		mLabelCache  = parser.isSet( "label-cache" );
+		mStreamMerge = parser.isSet( "stream-merge" );
+
+		foreach ( const QString& name, QStringList() << "copies" << "first" << "jobs" )
+		{
+			if ( parser.value( name ).toInt() < 1 )
+			{
+				errorString = QCoreApplication::translate( "BatchJob", "Invalid value \"%1\" for option \"%2\"." )
+					.arg( parser.value( name ) ).arg( name );
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	///
+	/// Set options from JSON object
+	///
+	/// Keys match the long command line options, plus "file" for the project
+	/// file.  An "id" is accepted and ignored.  Keys that are not present keep
+	/// their current values, except that "printer" and "output" each replace
+	/// the other.  Counts ("copies", "first" and "jobs") must be 1 or more.
+	///
+	bool BatchJob::setOptions( const QJsonObject& object, QString& errorString )
+	{
+		for ( auto it = object.constBegin(); it != object.constEnd(); ++it )
+		{
+			const QString&    key   = it.key();
+			const QJsonValue& value = it.value();
+
+			if ( key == "id" )
+			{
+				continue;
+			}
+			else if ( key == "file" && value.isString() )
+			{
+				mFilename = value.toString();
+			}
+			else if ( key == "printer" && value.isString() )
+			{
+				mPrinterName = value.toString();
+				mOutputFilename.clear(); // Overrides any default output
+			}
+			else if ( key == "output" && value.isString() )
+			{
+				mOutputFilename = value.toString();
+				mPrinterName.clear(); // Overrides any default printer
+			}
+			else if ( key == "copies" && value.isDouble() && (value.toInt() >= 1) )
+			{
+				mNCopies = value.toInt();
+			}
+			else if ( key == "first" && value.isDouble() && (value.toInt() >= 1) )
+			{
+				mFirstLabel = value.toInt();
+			}
+			else if ( key == "outlines" && value.isBool() )
+			{
+				mOutlines = value.toBool();
+			}
+			else if ( key == "crop-marks" && value.isBool() )
+			{
+				mCropMarks = value.toBool();
+			}
+			else if ( key == "reverse" && value.isBool() )
+			{
+				mReverse = value.toBool();
+			}
+			else if ( key == "jobs" && value.isDouble() && (value.toInt() >= 1) )
+			{
+				mNJobs = value.toInt();
+			}
+			else if ( key == "label-cache" && value.isBool() )
+			{
+				mLabelCache = value.toBool();
+			}
+			else if ( key == "stream-merge" && value.isBool() )
+			{
+				mStreamMerge = value.toBool();
+			}
+			else
+			{
+				errorString = QCoreApplication::translate( "BatchJob", "Invalid job option or value \"%1\"." ).arg( key );
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	///
+	/// Print job
+	///
+	bool BatchJob::print( QString& errorString ) const
+	{
+		if ( mFilename.isEmpty() )
+		{
+			errorString = QCoreApplication::translate( "BatchJob", "Missing glabels project file." );
+			return false;
+		}
+
+		merge::Factory::setStreaming( mStreamMerge );
+
+		model::Model* model = model::XmlLabelParser::readFile( mFilename );
+		if ( !model )
+		{
+			errorString = QCoreApplication::translate( "BatchJob", "Unable to read glabels project file \"%1\"." ).arg( mFilename );
+			return false;
+		}
+
+		QPrinter printer( QPrinter::HighResolution );
+		printer.setColorMode( QPrinter::Color );
+		if ( !mPrinterName.isEmpty() )
+		{
+			qDebug() << "Batch mode.  printer =" << mPrinterName;
+			printer.setPrinterName( mPrinterName );
+		}
+		else if ( !mOutputFilename.isEmpty() )
+		{
+			QString outputFilename = mOutputFilename;
+			if ( outputFilename == "-" )
+			{
+				outputFilename = STDOUT_FILENAME;
+			}
+			qDebug() << "Batch mode.  output =" << outputFilename;
+			printer.setOutputFileName( outputFilename );
+		}
+		else
+		{
+			qDebug() << "Batch mode.  printer =" << QPrinterInfo::defaultPrinterName();
+		}
+
+		{
+			model::PageRenderer renderer( model );
+			renderer.setNCopies( mNCopies );
+			renderer.setStartLabel( mFirstLabel - 1 );
+			renderer.setPrintOutlines( mOutlines );
+			renderer.setPrintCropMarks( mCropMarks );
+			renderer.setPrintReverse( mReverse );
+			renderer.setLabelCache( mLabelCache );
+			renderer.print( &printer, mNJobs );
+		}
+
+		delete model->merge(); // Final instance owned by us
+		delete model->variables();
+		delete model;
+
+		if ( printer.printerState() == QPrinter::Error )
+		{
+			errorString = QCoreApplication::translate( "BatchJob", "Unable to print \"%1\"." ).arg( mFilename );
+			return false;
+		}
+
+		return true;
+	}
+
+}
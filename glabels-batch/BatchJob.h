@@ -0,0 +1,89 @@
+/*  BatchJob.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BatchJob_h
+#define BatchJob_h
+
+
+#include <QCommandLineParser>
+#include <QJsonObject>
+#include <QString>
+
+
+namespace glabels
+{
+
+	///
+	/// Batch Print Job
+	///
+	/// Describes one project to print and how to print it.  Settings are
+	/// initialized from the command line, and may be overridden per job by a
+	/// JSON object (see BatchServer).
+	///
+	class BatchJob
+	{
+
+		/////////////////////////////////
+		// Life Cycle
+		/////////////////////////////////
+	public:
+		BatchJob();
+
+
+		/////////////////////////////////
+		// Properties
+		/////////////////////////////////
+	public:
+		QString filename() const;
+		QString outputFilename() const;
+
+
+		/////////////////////////////////
+		// Methods
+		/////////////////////////////////
+	public:
+		bool setOptions( const QCommandLineParser& parser, QString& errorString );
+		bool setOptions( const QJsonObject& object, QString& errorString );
+
+		bool print( QString& errorString ) const;
+
+
+		/////////////////////////////////
+		// Private data
+		/////////////////////////////////
+	private:
+		QString mFilename;
+		QString mPrinterName;
+		QString mOutputFilename;
+		int     mNCopies;
+		int     mFirstLabel;
+		bool    mOutlines;
+		bool    mCropMarks;
+		bool    mReverse;
+		int     mNJobs;
+		bool    mLabelCache;
+		bool    mStreamMerge;
+
+	};
+
+}
+
+
+#endif // BatchJob_h
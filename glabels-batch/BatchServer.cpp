@@ -0,0 +1,180 @@
+/*  BatchServer.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BatchServer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtDebug>
+
+#include <cstdio>
+
+
+namespace glabels
+{
+
+	///
+	/// Constructor
+	///
+	BatchServer::BatchServer( const BatchJob& defaults ) : mDefaults(defaults)
+	{
+		// empty
+	}
+
+
+	///
+	/// Serve requests from stdin, replying on stdout, until end of input
+	///
+	int BatchServer::serveStdio()
+	{
+		QFile input;
+		QFile output;
+		if ( !input.open( stdin, QIODevice::ReadOnly ) || !output.open( stdout, QIODevice::WriteOnly ) )
+		{
+			qWarning() << "Error: unable to open standard input/output.";
+			return -1;
+		}
+
+		qDebug() << "Batch server reading jobs from standard input.";
+
+		for (;;)
+		{
+			QByteArray line = input.readLine();
+			if ( line.isEmpty() )
+			{
+				break; // End of input
+			}
+
+			line = line.trimmed();
+			if ( !line.isEmpty() )
+			{
+				output.write( runRequest( line, true ) );
+				output.flush();
+			}
+		}
+
+		return 0;
+	}
+
+
+	///
+	/// Serve requests from local socket, one connection at a time
+	///
+	/// On Unix, name may be an absolute path of the socket to create.
+	///
+	int BatchServer::serveSocket( const QString& name )
+	{
+		QLocalServer::removeServer( name ); // Remove any stale socket
+
+		QLocalServer server;
+		if ( !server.listen( name ) )
+		{
+			qWarning() << "Error: unable to listen on" << name << ":" << server.errorString();
+			return -1;
+		}
+
+		qDebug() << "Batch server listening on" << server.fullServerName();
+
+		while ( server.waitForNewConnection( -1 ) )
+		{
+			QLocalSocket* socket = server.nextPendingConnection();
+
+			for (;;)
+			{
+				if ( socket->canReadLine() )
+				{
+					QByteArray line = socket->readLine().trimmed();
+					if ( !line.isEmpty() )
+					{
+						socket->write( runRequest( line, false ) );
+						socket->waitForBytesWritten( -1 );
+					}
+				}
+				else if ( !socket->waitForReadyRead( -1 ) )
+				{
+					break; // Disconnected
+				}
+			}
+
+			delete socket;
+		}
+
+		qWarning() << "Error: batch server stopped:" << server.errorString();
+		return -1;
+	}
+
+
+	///
+	/// Run a single request, returning the reply line
+	///
+	QByteArray BatchServer::runRequest( const QByteArray& line, bool stdoutReserved ) const
+	{
+		QJsonObject reply;
+		QString     errorString;
+
+		QJsonParseError parseError;
+		QJsonDocument   request = QJsonDocument::fromJson( line, &parseError );
+
+		if ( !request.isObject() )
+		{
+			errorString = QCoreApplication::translate( "BatchServer", "Invalid job request: %1." )
+				.arg( parseError.error != QJsonParseError::NoError ? parseError.errorString() : "not an object" );
+		}
+		else
+		{
+			QJsonObject object = request.object();
+			if ( object.contains( "id" ) )
+			{
+				reply.insert( "id", object.value( "id" ) );
+			}
+
+			BatchJob job = mDefaults;
+			if ( job.setOptions( object, errorString ) )
+			{
+				if ( stdoutReserved && (job.outputFilename() == "-") )
+				{
+					errorString = QCoreApplication::translate( "BatchServer", "Output to stdout is not available, stdout is used for replies." );
+				}
+				else
+				{
+					job.print( errorString );
+				}
+			}
+		}
+
+		if ( errorString.isEmpty() )
+		{
+			reply.insert( "status", "ok" );
+		}
+		else
+		{
+			qWarning() << "Error:" << errorString;
+			reply.insert( "status", "error" );
+			reply.insert( "error", errorString );
+		}
+
+		return QJsonDocument( reply ).toJson( QJsonDocument::Compact ) + '\n';
+	}
+
+}
@@ -0,0 +1,84 @@
+/*  BatchServer.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BatchServer_h
+#define BatchServer_h
+
+
+#include "BatchJob.h"
+
+#include <QByteArray>
+#include <QString>
+
+
+namespace glabels
+{
+
+	///
+	/// Batch Render Server
+	///
+	/// Prints a stream of jobs without re-initializing the template database and
+	/// other subsystems for each one.  Each request is a single line containing a
+	/// JSON object, e.g.
+	///
+	///     {"id":"42", "file":"order.glabels", "output":"order.pdf", "copies":2}
+	///
+	/// Options not given in a request default to those given on the command line.
+	/// Each request is answered with a single line JSON object, with "status" set
+	/// to "ok" or "error" (plus an "error" message), and the request "id", if any.
+	/// Requests are processed one at a time, in order.
+	///
+	class BatchServer
+	{
+
+		/////////////////////////////////
+		// Life Cycle
+		/////////////////////////////////
+	public:
+		BatchServer( const BatchJob& defaults );
+
+
+		/////////////////////////////////
+		// Methods
+		/////////////////////////////////
+	public:
+		int serveStdio();
+		int serveSocket( const QString& name );
+
+
+		/////////////////////////////////
+		// Private methods
+		/////////////////////////////////
+	private:
+		QByteArray runRequest( const QByteArray& line, bool stdoutReserved ) const;
+
+
+		/////////////////////////////////
+		// Private data
+		/////////////////////////////////
+	private:
+		BatchJob mDefaults;
+
+	};
+
+}
+
+
+#endif // BatchServer_h
@@ -18,13 +18,13 @@
  *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "BatchJob.h"
+#include "BatchServer.h"
+
 #include "model/FileUtil.h"
 #include "model/Db.h"
-#include "model/Model.h"
-#include "model/PageRenderer.h"
 #include "model/Settings.h"
 #include "model/Version.h"
-#include "model/XmlLabelParser.h"
 
 #include "barcode/Backends.h"
 #include "merge/Factory.h"
@@ -33,26 +33,11 @@
 #include <QCommandLineParser>
 #include <QLibraryInfo>
 #include <QLocale>
-#include <QPrinter>
 #include <QPrinterInfo>
 #include <QTranslator>
 #include <QtDebug>
 
 
-namespace
-{
-	
-#if defined(Q_OS_WIN)
-	const QString STDOUT_FILENAME = "CON:";
-#elif defined(Q_OS_LINUX)
-	const QString STDOUT_FILENAME = "/dev/stdout";
-#else
-	const QString STDOUT_FILENAME = "/dev/stdout";
-#endif
-
-}
-
-
 int main( int argc, char **argv )
 {
 	QGuiApplication app( argc, argv );
@@ -121,7 +106,24 @@ int main( int argc, char **argv )
 		 QCoreApplication::translate( "main", "Print crop marks." ) },
 		
 		{{"r","reverse"},
-		 QCoreApplication::translate( "main", "Print in reverse (mirror image)." ) }
+		 QCoreApplication::translate( "main", "Print in reverse (mirror image)." ) },
+
+		{{"j","jobs"},
+		 QCoreApplication::translate( "main", "Render pages using <n> parallel jobs. (Default=1)" ),
+		 "n", "1" },
+
+		{"label-cache",
+		 QCoreApplication::translate( "main", "Draw each distinct label once and reuse it for identical labels." ) },
+
+		{"stream-merge",
+		 QCoreApplication::translate( "main", "Read merge records on demand, rather than loading the whole merge source up front." ) },
+
+		{"server",
+		 QCoreApplication::translate( "main", "Run as a render server, reading jobs from stdin and replying on stdout, one per line." ) },
+
+		{"socket",
+		 QCoreApplication::translate( "main", "Run as a render server, accepting jobs on local socket <name>." ),
+		 QCoreApplication::translate( "main", "name" ) }
 	};
 
 
@@ -145,42 +147,31 @@ int main( int argc, char **argv )
 	glabels::barcode::Backends::init();
 
 	
-	if ( parser.positionalArguments().size() == 1 )
+	glabels::BatchJob job;
+	QString optionsErrorString;
+	if ( !job.setOptions( parser, optionsErrorString ) )
 	{
-		QString filename = parser.positionalArguments().constFirst();
+		qWarning() << "Error:" << optionsErrorString;
+		return -1;
+	}
 
-		glabels::model::Model *model = glabels::model::XmlLabelParser::readFile( filename );
-		if ( model )
+	if ( parser.isSet( "socket" ) )
+	{
+		glabels::BatchServer server( job );
+		return server.serveSocket( parser.value( "socket" ) );
+	}
+	else if ( parser.isSet( "server" ) )
+	{
+		glabels::BatchServer server( job );
+		return server.serveStdio();
+	}
+	else if ( parser.positionalArguments().size() == 1 )
+	{
+		QString errorString;
+		if ( !job.print( errorString ) )
 		{
-			QPrinter printer( QPrinter::HighResolution );
-			printer.setColorMode( QPrinter::Color );
-			if ( parser.isSet("printer") )
-			{
-				qDebug() << "Batch mode.  printer =" << parser.value("printer");
-				printer.setPrinterName( parser.value("printer") );
-			}
-			else if ( parser.isSet("output") )
-			{
-				QString outputFilename = parser.value("output");
-				if ( outputFilename == "-" )
-				{
-					outputFilename = STDOUT_FILENAME;
-				}
-				qDebug() << "Batch mode.  output =" << outputFilename;
-				printer.setOutputFileName( outputFilename );
-			}
-			else
-			{
-				qDebug() << "Batch mode.  printer =" << QPrinterInfo::defaultPrinterName();
-			}
-
-			glabels::model::PageRenderer renderer( model );
-			renderer.setNCopies( parser.value( "copies" ).toInt() );
-			renderer.setStartLabel( parser.value( "first" ).toInt() - 1 );
-			renderer.setPrintOutlines( parser.isSet( "outlines" ) );
-			renderer.setPrintCropMarks( parser.isSet( "crop-marks" ) );
-			renderer.setPrintReverse( parser.isSet( "reverse" ) );
-			renderer.print( &printer );
+			qWarning() << "Error:" << errorString;
+			return -1;
 		}
 	}
 	else
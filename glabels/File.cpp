@@ -193,7 +193,8 @@ namespace glabels
 			return true;
 		}
 
-		model::XmlLabelCreator::writeFile( window->model(), window->model()->fileName() );
+		model::XmlLabelCreator::writeFile( window->model(), window->model()->fileName(),
+		                                   model::Settings::compressionLevel() );
 		window->model()->clearModified();
 		model::Settings::addToRecentFileList( window->model()->fileName() );
 
@@ -249,7 +250,7 @@ namespace glabels
 				}
 			}
 			
-			model::XmlLabelCreator::writeFile( window->model(), fileName );
+			model::XmlLabelCreator::writeFile( window->model(), fileName, model::Settings::compressionLevel() );
 			window->model()->setFileName( fileName );
 			window->model()->clearModified();
 			model::Settings::addToRecentFileList( fileName );
@@ -72,6 +72,8 @@ namespace glabels
 		const QColor  markupLineColor( 240, 99, 99 );
 		const double  markupLineWidthPixels = 1;
 
+		const double  objectMarginPixels = 8; // Handles, outlines and antialiasing
+
 		const QColor  selectRegionFillColor( 192, 192, 255, 128 );
 		const QColor  selectRegionOutlineColor( 0, 0, 255, 128 );
 		const double  selectRegionOutlineWidthPixels = 3;
@@ -103,6 +105,8 @@ namespace glabels
 		mCreateObjectType    = Box;
 		mCreateObject        = nullptr;
 
+		mFirstDynamicObject  = 0;
+
 		setMouseTracking( true );
 		setFocusPolicy(Qt::StrongFocus);
 
@@ -149,13 +153,14 @@ namespace glabels
 	{
 		mModel = model;
 		mUndoRedoModel = undoRedoModel;
+		mStaticLayerKey.clear();
 
 		if ( model )
 		{
 			zoomToFit();
 
-			connect( model, SIGNAL(changed()), this, SLOT(update()) );
-			connect( model, SIGNAL(selectionChanged()), this, SLOT(update()) );
+			connect( model, SIGNAL(changed()), this, SLOT(onModelChanged()) );
+			connect( model, SIGNAL(selectionChanged()), this, SLOT(onModelSelectionChanged()) );
 			connect( model, SIGNAL(sizeChanged()), this, SLOT(onModelSizeChanged()) );
 
 			update();
@@ -1000,26 +1005,23 @@ namespace glabels
 	{
 		if ( mModel )
 		{
+			updateStaticLayer();
+
 			QPainter painter( this );
 
+			/* Background, grid, markup and unselected objects below the selection */
+			painter.drawPixmap( 0, 0, mStaticLayer );
+
 			painter.setRenderHint( QPainter::Antialiasing, true );
 			painter.setRenderHint( QPainter::TextAntialiasing, true );
 			painter.setRenderHint( QPainter::SmoothPixmapTransform, true );
 		
-			/* Fill background before any transformations */
-			painter.setBrush( QBrush( backgroundColor ) );
-			painter.setPen( Qt::NoPen );
-			painter.drawRect( rect() );
-
 			/* Transform. */
 			painter.scale( mScale, mScale );
 			painter.translate( mX0.pt(), mY0.pt() );
 
-			/* Now draw from the bottom layer up. */
-			drawBgLayer( &painter );
-			drawGridLayer( &painter );
-			drawMarkupLayer( &painter );
-			drawObjectsLayer( &painter );
+			/* Now draw remaining layers from the bottom up. */
+			drawObjectsLayer( &painter, event->rect() );
 			drawFgLayer( &painter );
 			drawHighlightLayer( &painter );
 			drawSelectRegionLayer( &painter );
@@ -1027,6 +1029,215 @@ namespace glabels
 	}
 
 
+	///
+	/// Update static layers
+	///
+	/// The whole pixmap is redrawn when its size, zoom, origin, visible layers,
+	/// or template change.  Otherwise only the dirty region left by changed
+	/// objects is redrawn.
+	///
+	void
+	LabelEditor::updateStaticLayer()
+	{
+		double dpr = devicePixelRatioF();
+
+		QString key = QString::number( width() )
+			+ QChar(0x1F) + QString::number( height() )
+			+ QChar(0x1F) + QString::number( dpr )
+			+ QChar(0x1F) + QString::number( mScale )
+			+ QChar(0x1F) + QString::number( mX0.pt() )
+			+ QChar(0x1F) + QString::number( mY0.pt() )
+			+ QChar(0x1F) + QString::number( mGridVisible )
+			+ QChar(0x1F) + QString::number( mMarkupVisible )
+			+ QChar(0x1F) + QString::number( mModel->rotate() )
+			+ QChar(0x1F) + QString::number( mModel->w().pt() )
+			+ QChar(0x1F) + QString::number( mModel->h().pt() )
+			+ QChar(0x1F) + mModel->tmplate()->name()
+			+ QChar(0x1F) + mModel->frame()->id()
+			+ QChar(0x1F) + QString::number( mModel->frame()->markups().size() );
+
+		if ( key != mStaticLayerKey )
+		{
+			mStaticLayerKey = key;
+
+			mStaticLayer = QPixmap( size() * dpr );
+			mStaticLayer.setDevicePixelRatio( dpr );
+			mStaticDirtyRegion = rect();
+
+			trackObjects();
+		}
+
+		if ( mStaticDirtyRegion.isEmpty() )
+		{
+			return;
+		}
+
+		QPainter painter( &mStaticLayer );
+		painter.setClipRegion( mStaticDirtyRegion );
+
+		painter.setRenderHint( QPainter::Antialiasing, true );
+		painter.setRenderHint( QPainter::TextAntialiasing, true );
+		painter.setRenderHint( QPainter::SmoothPixmapTransform, true );
+
+		/* Fill background before any transformations */
+		painter.setBrush( QBrush( backgroundColor ) );
+		painter.setPen( Qt::NoPen );
+		painter.drawRect( rect() );
+
+		/* Transform. */
+		painter.scale( mScale, mScale );
+		painter.translate( mX0.pt(), mY0.pt() );
+
+		drawBgLayer( &painter );
+		drawGridLayer( &painter );
+		drawMarkupLayer( &painter );
+
+		QRect dirtyRect = mStaticDirtyRegion.boundingRect();
+		for ( int i = 0; i < mFirstDynamicObject; i++ )
+		{
+			if ( mObjectRects.value( mObjects[i] ).intersects( dirtyRect ) )
+			{
+				mObjects[i]->draw( &painter, true, nullptr, nullptr );
+			}
+		}
+
+		mStaticDirtyRegion = QRegion();
+	}
+
+
+	///
+	/// Track object list of model
+	///
+	/// Records where each object is drawn, so that only the area it covered
+	/// before and after a change has to be redrawn.
+	///
+	void
+	LabelEditor::trackObjects()
+	{
+		mObjects = mModel->objectList();
+		mObjectRects.clear();
+
+		foreach ( model::ModelObject* object, mObjects )
+		{
+			mObjectRects.insert( object, objectRect( object ) );
+
+			connect( object, SIGNAL(changed()), this, SLOT(onObjectChanged()), Qt::UniqueConnection );
+			connect( object, SIGNAL(moved()), this, SLOT(onObjectChanged()), Qt::UniqueConnection );
+		}
+
+		mFirstDynamicObject = firstDynamicObject();
+	}
+
+
+	///
+	/// Index of lowest selected object
+	///
+	/// Objects from here up are drawn on every paint, to keep their stacking order
+	/// with the selected objects.
+	///
+	int
+	LabelEditor::firstDynamicObject() const
+	{
+		for ( int i = 0; i < mObjects.size(); i++ )
+		{
+			if ( mObjects[i]->isSelected() )
+			{
+				return i;
+			}
+		}
+
+		return mObjects.size();
+	}
+
+
+	///
+	/// Area of widget drawn by object, including shadow and selection handles
+	///
+	QRect
+	LabelEditor::objectRect( const model::ModelObject* object ) const
+	{
+		QRectF rect = object->hoverRect( mScale );
+		if ( object->shadow() )
+		{
+			rect = rect.united( rect.translated( object->shadowX().pt(), object->shadowY().pt() ) );
+		}
+
+		rect.translate( mX0.pt(), mY0.pt() );
+		QRectF deviceRect( rect.x()*mScale, rect.y()*mScale, rect.width()*mScale, rect.height()*mScale );
+
+		int margin = int( objectMarginPixels );
+		return deviceRect.toAlignedRect().adjusted( -margin, -margin, margin, margin );
+	}
+
+
+	///
+	/// Model changed handler
+	///
+	/// Changes to individual objects are handled by onObjectChanged().  Anything
+	/// else that changes the object list redraws everything.
+	///
+	void
+	LabelEditor::onModelChanged()
+	{
+		if ( mModel->objectList() != mObjects )
+		{
+			trackObjects();
+			mStaticDirtyRegion = rect();
+			update();
+		}
+	}
+
+
+	///
+	/// Model selection changed handler
+	///
+	void
+	LabelEditor::onModelSelectionChanged()
+	{
+		int first = firstDynamicObject();
+		if ( first != mFirstDynamicObject )
+		{
+			// Objects move between static and dynamic layers
+			for ( int i = qMin( first, mFirstDynamicObject ); i < qMax( first, mFirstDynamicObject ); i++ )
+			{
+				mStaticDirtyRegion += mObjectRects.value( mObjects[i] );
+			}
+			mFirstDynamicObject = first;
+		}
+
+		update();
+	}
+
+
+	///
+	/// Object changed or moved handler
+	///
+	/// Only the area covered by the object before and after the change is
+	/// repainted.
+	///
+	void
+	LabelEditor::onObjectChanged()
+	{
+		auto* object = qobject_cast<model::ModelObject*>( sender() );
+		if ( !object || !mObjectRects.contains( object ) )
+		{
+			return;
+		}
+
+		QRect oldRect = mObjectRects.value( object );
+		QRect newRect = objectRect( object );
+		mObjectRects.insert( object, newRect );
+
+		QRect dirtyRect = oldRect.united( newRect );
+		if ( mObjects.indexOf( object ) < mFirstDynamicObject )
+		{
+			mStaticDirtyRegion += dirtyRect;
+		}
+
+		update( dirtyRect );
+	}
+
+
 	///
 	/// Draw Background Layer
 	///
@@ -1103,7 +1314,7 @@ namespace glabels
 				painter->translate( -mModel->frame()->w().pt(), 0 );
 			}
 
-			painter->setClipPath( mModel->frame()->path() );
+			painter->setClipPath( mModel->frame()->path(), Qt::IntersectClip );
 
 			QPen pen( gridLineColor, gridLineWidthPixels );
 			pen.setCosmetic( true );
@@ -1160,9 +1371,15 @@ namespace glabels
 	/// Draw Objects Layer
 	///
 	void
-	LabelEditor::drawObjectsLayer( QPainter* painter )
+	LabelEditor::drawObjectsLayer( QPainter* painter, const QRect& rect )
 	{
-		mModel->draw( painter, true, nullptr, nullptr );
+		for ( int i = mFirstDynamicObject; i < mObjects.size(); i++ )
+		{
+			if ( mObjectRects.value( mObjects[i] ).intersects( rect ) )
+			{
+				mObjects[i]->draw( painter, true, nullptr, nullptr );
+			}
+		}
 	}
 
 
@@ -27,7 +27,10 @@
 #include "model/ModelObject.h"
 #include "model/Region.h"
 
+#include <QHash>
 #include <QPainter>
+#include <QPixmap>
+#include <QRegion>
 #include <QScrollArea>
 #include <QWidget>
 
@@ -138,11 +141,16 @@ namespace glabels
 		void drawBgLayer( QPainter* painter );
 		void drawGridLayer( QPainter* painter );
 		void drawMarkupLayer( QPainter* painter );
-		void drawObjectsLayer( QPainter* painter );
+		void drawObjectsLayer( QPainter* painter, const QRect& rect );
 		void drawFgLayer( QPainter* painter );
 		void drawHighlightLayer( QPainter* painter );
 		void drawSelectRegionLayer( QPainter* painter );
 
+		void updateStaticLayer();
+		void trackObjects();
+		int firstDynamicObject() const;
+		QRect objectRect( const model::ModelObject* object ) const;
+
 
 		/////////////////////////////////////
 		// Private slots
@@ -150,6 +158,9 @@ namespace glabels
 	private slots:
 		void onSettingsChanged();
 		void onModelSizeChanged();
+		void onModelChanged();
+		void onModelSelectionChanged();
+		void onObjectChanged();
 
 
 		/////////////////////////////////////
@@ -191,6 +202,16 @@ namespace glabels
 		double               mGridSpacing;
 		model::Distance      mStepSize;
 
+		/* Cached static layers: background, grid, markup and objects below the
+		 * lowest selected object */
+		QPixmap              mStaticLayer;
+		QString              mStaticLayerKey;
+		QRegion              mStaticDirtyRegion;
+
+		QList<model::ModelObject*>                mObjects;
+		QHash<const model::ModelObject*,QRect>    mObjectRects;
+		int                                       mFirstDynamicObject;
+
 		State                mState;
 
 		/* ArrowSelectRegion state */
@@ -283,7 +283,7 @@ namespace glabels
 			auto* item = new QTableWidgetItem();
 			if ( record->contains( mPrimaryKey ) )
 			{
-				item->setText( (*record)[mPrimaryKey] );
+				item->setText( record->value( mPrimaryKey ) );
 			}
 			item->setFlags( Qt::ItemIsEnabled | Qt::ItemIsUserCheckable );
 			item->setCheckState( record->isSelected() ? Qt::Checked : Qt::Unchecked );
@@ -298,7 +298,7 @@ namespace glabels
 				{
 					if ( record->contains( key ) )
 					{
-						auto* item = new QTableWidgetItem( (*record)[key] );
+						auto* item = new QTableWidgetItem( record->value( key ) );
 						item->setFlags( Qt::ItemIsEnabled );
 						recordsTable->setItem( iRow, iCol, item );
 						recordsTable->resizeColumnToContents( iCol );
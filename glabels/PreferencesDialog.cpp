@@ -52,6 +52,8 @@ namespace glabels
 			unitsPointsRadio->setChecked( true );
 			break;
 		}
+
+		compressionLevelSpin->setValue( model::Settings::compressionLevel() );
 	}
 
 
@@ -82,4 +84,13 @@ namespace glabels
 		}
 	}
 
+
+	///
+	/// Compression Level Spin Changed
+	///
+	void PreferencesDialog::onCompressionLevelSpinChanged()
+	{
+		model::Settings::setCompressionLevel( compressionLevelSpin->value() );
+	}
+
 } // namespace glabels
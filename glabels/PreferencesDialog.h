@@ -47,6 +47,7 @@ namespace glabels
 		/////////////////////////////////
 	private slots:
 		void onUnitsRadiosChanged();
+		void onCompressionLevelSpinChanged();
 
 	};
 
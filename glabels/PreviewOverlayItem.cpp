@@ -20,30 +20,296 @@
 
 #include "PreviewOverlayItem.h"
 
+#include "model/Model.h"
 #include "model/PageRenderer.h"
 
+#include "merge/Merge.h"
+
+#include <QPainter>
+#include <QPicture>
+#include <QStyleOptionGraphicsItem>
 #include <QtDebug>
 
+#include <cmath>
+
 
 namespace glabels
 {
 
+	//
+	// Private
+	//
+	namespace
+	{
+		const double placeholderScale = 0.25;
+		const int    tileSizePixels   = 512;
+		const int    maxImageSizePixels = 8192;
+
+
+		///
+		/// Size of page image at scale, in pixels
+		///
+		QSize imageSize( const QRectF& pageRect, double scale )
+		{
+			return QSize( qMax( 1, int( std::ceil( pageRect.width()*scale ) ) ),
+			              qMax( 1, int( std::ceil( pageRect.height()*scale ) ) ) );
+		}
+	}
+
+
+	///
+	/// Worker Constructor
+	///
+	/// The worker takes ownership of renderer, which must be a clone from
+	/// model::PageRenderer::cloneForWorker() with its own merge, since the
+	/// original model may replace its merge while the worker is running.
+	///
+	PreviewOverlayWorker::PreviewOverlayWorker( model::PageRenderer* renderer, double scale, bool placeholder )
+		: mRenderer(renderer), mScale(scale), mPlaceholder(placeholder), mCancelled(0)
+	{
+		mRenderer->setAbortFlag( &mCancelled );
+	}
+
+
+	///
+	/// Worker Destructor
+	///
+	PreviewOverlayWorker::~PreviewOverlayWorker()
+	{
+		cancel();
+		wait();
+
+		auto* model = mRenderer->model();
+		delete mRenderer;
+		delete model->merge();
+		delete model->variables();
+		delete model;
+	}
+
+
+	///
+	/// Cancel rendering, as soon as the current label or tile is done
+	///
+	void PreviewOverlayWorker::cancel()
+	{
+		mCancelled.store( 1 );
+	}
+
+
+	///
+	/// Render page
+	///
+	/// Labels are drawn once into a QPicture, which is then rasterized into the
+	/// placeholder and each tile.
+	///
+	void PreviewOverlayWorker::run()
+	{
+		QRectF pageRect = mRenderer->pageRect();
+
+		QPicture picture;
+		QPainter picturePainter( &picture );
+		mRenderer->printPage( &picturePainter );
+		picturePainter.end();
+
+		if ( mCancelled.load() )
+		{
+			return;
+		}
+
+		if ( mPlaceholder )
+		{
+			double scale = placeholderScale * mScale;
+
+			QImage image( imageSize( pageRect, scale ), QImage::Format_ARGB32_Premultiplied );
+			image.fill( Qt::transparent );
+
+			QPainter painter( &image );
+			painter.setRenderHint( QPainter::Antialiasing );
+			painter.scale( scale, scale );
+			painter.drawPicture( 0, 0, picture );
+			painter.end();
+
+			emit placeholderRendered( image );
+		}
+
+		QSize size = imageSize( pageRect, mScale );
+		for ( int y = 0; y < size.height(); y += tileSizePixels )
+		{
+			for ( int x = 0; x < size.width(); x += tileSizePixels )
+			{
+				if ( mCancelled.load() )
+				{
+					return;
+				}
+
+				int w = qMin( tileSizePixels, size.width() - x );
+				int h = qMin( tileSizePixels, size.height() - y );
+
+				QImage image( w, h, QImage::Format_ARGB32_Premultiplied );
+				image.fill( Qt::transparent );
+
+				QPainter painter( &image );
+				painter.setRenderHint( QPainter::Antialiasing );
+				painter.translate( -x, -y );
+				painter.scale( mScale, mScale );
+				painter.drawPicture( 0, 0, picture );
+				painter.end();
+
+				emit tileRendered( image, QRectF( x/mScale, y/mScale, w/mScale, h/mScale ) );
+			}
+		}
+	}
+
+
+	///
+	/// Constructor
+	///
 	PreviewOverlayItem::PreviewOverlayItem( const model::PageRenderer* renderer, QGraphicsItem* parent )
-		: QGraphicsItem(parent), mRenderer(renderer)
+		: QGraphicsObject(parent), mRenderer(renderer), mTileScale(0)
 	{
 		// empty
 	}
 
 
+	///
+	/// Destructor
+	///
+	/// A running worker is cancelled and deletes itself once finished.
+	///
+	PreviewOverlayItem::~PreviewOverlayItem()
+	{
+		if ( mWorker )
+		{
+			mWorker->cancel();
+		}
+	}
+
+
 	QRectF PreviewOverlayItem::boundingRect() const
 	{
 		return mRenderer->pageRect();
 	}
 
 
-	void PreviewOverlayItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget )
+	///
+	/// Paint
+	///
+	/// Draws whatever has been rendered so far, and starts rendering in the
+	/// background if the zoom level has changed.
+	///
+	void PreviewOverlayItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* )
+	{
+		QRectF pageRect = boundingRect();
+		if ( pageRect.isEmpty() )
+		{
+			return;
+		}
+
+		double scale = option->levelOfDetailFromTransform( painter->worldTransform() );
+		scale = qMin( scale, maxImageSizePixels / qMax( pageRect.width(), pageRect.height() ) );
+
+		if ( !qFuzzyCompare( scale, mTileScale ) )
+		{
+			startWorker( scale );
+		}
+
+		painter->save();
+		painter->setRenderHint( QPainter::SmoothPixmapTransform );
+
+		if ( !mPlaceholder.isNull() )
+		{
+			painter->drawImage( pageRect, mPlaceholder );
+		}
+		foreach ( const Tile& tile, mTiles )
+		{
+			painter->drawImage( tile.rect, tile.image );
+		}
+
+		painter->restore();
+	}
+
+
+	///
+	/// Start rendering at scale, cancelling any previous rendering
+	///
+	void PreviewOverlayItem::startWorker( double scale )
+	{
+		if ( mWorker )
+		{
+			mWorker->cancel();
+		}
+
+		flattenTiles();
+		mTileScale = scale;
+
+		mWorker = new PreviewOverlayWorker( mRenderer->cloneForWorker( true ), scale, mPlaceholder.isNull() );
+
+		connect( mWorker, SIGNAL(placeholderRendered(const QImage&)),
+		         this, SLOT(onPlaceholderRendered(const QImage&)) );
+		connect( mWorker, SIGNAL(tileRendered(const QImage&,const QRectF&)),
+		         this, SLOT(onTileRendered(const QImage&,const QRectF&)) );
+		connect( mWorker, SIGNAL(finished()), mWorker, SLOT(deleteLater()) );
+
+		mWorker->start( QThread::LowPriority );
+	}
+
+
+	///
+	/// Merge tiles from a previous scale into the placeholder
+	///
+	void PreviewOverlayItem::flattenTiles()
+	{
+		if ( mTiles.isEmpty() )
+		{
+			return;
+		}
+
+		QRectF pageRect = boundingRect();
+
+		QImage image( imageSize( pageRect, mTileScale ), QImage::Format_ARGB32_Premultiplied );
+		image.fill( Qt::transparent );
+
+		QPainter painter( &image );
+		painter.setRenderHint( QPainter::SmoothPixmapTransform );
+		painter.scale( mTileScale, mTileScale );
+		if ( !mPlaceholder.isNull() )
+		{
+			painter.drawImage( pageRect, mPlaceholder );
+		}
+		foreach ( const Tile& tile, mTiles )
+		{
+			painter.drawImage( tile.rect, tile.image );
+		}
+		painter.end();
+
+		mPlaceholder = image;
+		mTiles.clear();
+	}
+
+
+	///
+	/// Placeholder rendered handler
+	///
+	void PreviewOverlayItem::onPlaceholderRendered( const QImage& image )
+	{
+		if ( sender() == mWorker )
+		{
+			mPlaceholder = image;
+			update();
+		}
+	}
+
+
+	///
+	/// Tile rendered handler
+	///
+	void PreviewOverlayItem::onTileRendered( const QImage& image, const QRectF& rect )
 	{
-		mRenderer->printPage( painter );
+		if ( sender() == mWorker )
+		{
+			mTiles.append( { image, rect } );
+			update( rect );
+		}
 	}
 
 } // namespace glabels
@@ -24,23 +24,82 @@
 
 #include "model/PageRenderer.h"
 
-#include <QGraphicsItem>
+#include <QAtomicInt>
+#include <QGraphicsObject>
+#include <QImage>
+#include <QList>
+#include <QPointer>
+#include <QThread>
 
 
 namespace glabels
 {
 
+	///
+	///  PreviewOverlayWorker Thread
+	///
+	///  Renders the current page of a private renderer clone, first as a low
+	///  resolution placeholder, then as tiles at full resolution.
+	///
+	class PreviewOverlayWorker : public QThread
+	{
+		Q_OBJECT
+
+		/////////////////////////////////
+		// Life Cycle
+		/////////////////////////////////
+	public:
+		PreviewOverlayWorker( model::PageRenderer* renderer, double scale, bool placeholder );
+		~PreviewOverlayWorker() override;
+
+
+		/////////////////////////////////
+		// Public Methods
+		/////////////////////////////////
+	public:
+		void cancel();
+
+
+		/////////////////////////////////
+		// Signals
+		/////////////////////////////////
+	signals:
+		void placeholderRendered( const QImage& image );
+		void tileRendered( const QImage& image, const QRectF& rect );
+
+
+		/////////////////////////////////
+		// Thread implementation
+		/////////////////////////////////
+	protected:
+		void run() override;
+
+
+		/////////////////////////////////
+		// Private Data
+		/////////////////////////////////
+	private:
+		model::PageRenderer* mRenderer;
+		double               mScale;
+		bool                 mPlaceholder;
+		QAtomicInt           mCancelled;
+
+	};
+
+
 	///
 	///  PreviewOverlayItem Widget
 	///
-	class PreviewOverlayItem : public QGraphicsItem
+	class PreviewOverlayItem : public QGraphicsObject
 	{
+		Q_OBJECT
 
 		/////////////////////////////////
 		// Life Cycle
 		/////////////////////////////////
 	public:
 		PreviewOverlayItem( const model::PageRenderer* renderer, QGraphicsItem* parent = nullptr );
+		~PreviewOverlayItem() override;
 
 
 		/////////////////////////////////////
@@ -50,12 +109,43 @@ namespace glabels
 		QRectF boundingRect() const override;
 		void paint( QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget ) override;
 
+
+		/////////////////////////////////
+		// Private slots
+		/////////////////////////////////
+	private slots:
+		void onPlaceholderRendered( const QImage& image );
+		void onTileRendered( const QImage& image, const QRectF& rect );
+
+
+		/////////////////////////////////
+		// Internal Methods
+		/////////////////////////////////
+	private:
+		void startWorker( double scale );
+		void flattenTiles();
+
 		
 		/////////////////////////////////
 		// Private Data
 		/////////////////////////////////
 	private:
-		const model::PageRenderer* mRenderer;
+		///
+		/// Full resolution tile, in page coordinates
+		///
+		struct Tile
+		{
+			QImage image;
+			QRectF rect;
+		};
+
+		const model::PageRenderer*     mRenderer;
+
+		QImage                         mPlaceholder;
+		QList<Tile>                    mTiles;
+		double                         mTileScale;
+
+		QPointer<PreviewOverlayWorker> mWorker;
 
 	};
 
@@ -21,6 +21,7 @@
 #include "UndoRedoModel.h"
 
 #include "model/Model.h"
+#include "model/Settings.h"
 
 
 namespace glabels
@@ -66,8 +67,9 @@ namespace glabels
 			mRedoStack.clear();
 
 			/* Save state onto undo stack. */
-			auto* stateNow = new State( mModel, description );
+			State* stateNow = saveState( description );
 			mUndoStack.push( stateNow );
+			mUndoStack.trim( model::Settings::maxUndoLevels() );
 
 			/* Track consecutive checkpoints. */
 			mNewSelection = false;
@@ -84,11 +86,11 @@ namespace glabels
 	void UndoRedoModel::undo()
 	{
 		State* oldState = mUndoStack.pop();
-		auto* stateNow = new State( mModel, oldState->description );
+		State* stateNow = saveState( oldState->description );
 
 		mRedoStack.push( stateNow );
 
-		mModel->restore( oldState->model );
+		restoreState( oldState );
 		delete oldState;
 	
 		mNewSelection = true;
@@ -103,11 +105,11 @@ namespace glabels
 	void UndoRedoModel::redo()
 	{
 		State* oldState = mRedoStack.pop();
-		auto* stateNow = new State( mModel, oldState->description );
+		State* stateNow = saveState( oldState->description );
 
 		mUndoStack.push( stateNow );
 
-		mModel->restore( oldState->model );
+		restoreState( oldState );
 		delete oldState;
 	
 		mNewSelection = true;
@@ -175,13 +177,105 @@ namespace glabels
 	}
 
 
+	///
+	/// Object changed handler
+	///
+	/// The object no longer matches its snapshot.
+	///
+	void UndoRedoModel::onObjectChanged()
+	{
+		mSnapshots.remove( sender() );
+	}
+
+
+	///
+	/// Object destroyed handler
+	///
+	void UndoRedoModel::onObjectDestroyed( QObject* object )
+	{
+		mSnapshots.remove( object );
+	}
+
+
+	///
+	/// Save current model state
+	///
+	/// Only objects changed since their last snapshot are cloned, all others
+	/// share their existing snapshot.
+	///
+	UndoRedoModel::State* UndoRedoModel::saveState( const QString& description )
+	{
+		auto* state = new State();
+		state->model       = mModel->saveProperties();
+		state->description = description;
+
+		foreach ( model::ModelObject* object, mModel->objectList() )
+		{
+			QSharedPointer<model::ModelObject> snapshot = mSnapshots.value( object );
+			if ( !snapshot )
+			{
+				snapshot = QSharedPointer<model::ModelObject>( object->clone() );
+				mSnapshots.insert( object, snapshot );
+
+				connect( object, SIGNAL(changed()), this, SLOT(onObjectChanged()), Qt::UniqueConnection );
+				connect( object, SIGNAL(moved()), this, SLOT(onObjectChanged()), Qt::UniqueConnection );
+				connect( object, SIGNAL(destroyed(QObject*)), this, SLOT(onObjectDestroyed(QObject*)), Qt::UniqueConnection );
+			}
+
+			state->objects  << snapshot;
+			state->selected << object->isSelected();
+		}
+
+		return state;
+	}
+
+
+	///
+	/// Restore model state
+	///
+	/// Live objects still matching a snapshot of the state are kept as is, only
+	/// the others are cloned from their snapshots.
+	///
+	void UndoRedoModel::restoreState( const State* state )
+	{
+		QHash<const model::ModelObject*,model::ModelObject*> liveObjects;
+		QHash<QObject*,QSharedPointer<model::ModelObject>>::const_iterator i;
+		for ( i = mSnapshots.constBegin(); i != mSnapshots.constEnd(); ++i )
+		{
+			liveObjects.insert( i.value().data(), static_cast<model::ModelObject*>( i.key() ) );
+		}
+
+		QList<model::ModelObject*> objects;
+		for ( int iObject = 0; iObject < state->objects.size(); iObject++ )
+		{
+			const QSharedPointer<model::ModelObject>& snapshot = state->objects[iObject];
+
+			model::ModelObject* object = liveObjects.value( snapshot.data() );
+			if ( !object )
+			{
+				object = snapshot->clone();
+				mSnapshots.insert( object, snapshot );
+
+				connect( object, SIGNAL(changed()), this, SLOT(onObjectChanged()) );
+				connect( object, SIGNAL(moved()), this, SLOT(onObjectChanged()) );
+				connect( object, SIGNAL(destroyed(QObject*)), this, SLOT(onObjectDestroyed(QObject*)) );
+			}
+			object->select( state->selected[iObject] );
+
+			objects << object;
+		}
+
+		mModel->restore( state->model, objects );
+	}
+
+
 	///
 	/// State constructor
 	///
-	UndoRedoModel::State::State( model::Model* model, const QString& description )
+	UndoRedoModel::State::State()
+		: model(nullptr)
 	{
-		this->model = model->save();
-		this->description = description;
+		// empty
 	}
 
 
@@ -248,6 +342,18 @@ namespace glabels
 	}
 
 
+	///
+	/// Drop oldest states beyond maxStates
+	///
+	void UndoRedoModel::Stack::trim( int maxStates )
+	{
+		while ( list.size() > maxStates )
+		{
+			delete list.takeLast();
+		}
+	}
+
+
 	///
 	/// Clear stack
 	///
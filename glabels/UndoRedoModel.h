@@ -23,9 +23,12 @@
 
 
 #include "model/Model.h"
+#include "model/ModelObject.h"
 
+#include <QHash>
 #include <QList>
 #include <QObject>
+#include <QSharedPointer>
 #include <QString>
 
 
@@ -66,6 +69,8 @@ namespace glabels
 		/////////////////////////////////
 	private slots:
 		void onSelectionChanged();
+		void onObjectChanged();
+		void onObjectDestroyed( QObject* object );
 		
 
 		/////////////////////////////////
@@ -79,14 +84,22 @@ namespace glabels
 		// Private types
 		/////////////////////////////////
 	private:
+		///
+		/// Saved model state
+		///
+		/// Objects are immutable snapshots, shared with other states and with
+		/// live objects that have not changed since.
+		///
 		class State
 		{
 		public:
-			State( model::Model* model, const QString& description );
+			State();
 			~State();
 
-			model::Model* model;
-			QString       description;
+			model::Model*                               model;
+			QList<QSharedPointer<model::ModelObject>>   objects;
+			QList<bool>                                 selected;
+			QString                                     description;
 		};
 
 		class Stack
@@ -100,12 +113,21 @@ namespace glabels
 			const State* topState() const;
 			bool isEmpty() const;
 			void clear();
+			void trim( int maxStates );
 
 		private:
 			QList<State*> list;
 		};
 	
 
+		/////////////////////////////////
+		// Internal Methods
+		/////////////////////////////////
+	private:
+		State* saveState( const QString& description );
+		void restoreState( const State* state );
+	
+
 		/////////////////////////////////
 		// Private data
 		/////////////////////////////////
@@ -118,6 +140,8 @@ namespace glabels
 		bool           mNewSelection;
 		QString        mLastDescription;
 
+		QHash<QObject*,QSharedPointer<model::ModelObject>> mSnapshots;
+
 	};
 
 }
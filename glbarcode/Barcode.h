@@ -22,6 +22,7 @@
 #define glbarcode_Barcode_h
 
 
+#include <cstddef>
 #include <string>
 
 #include "Renderer.h"
@@ -178,6 +179,16 @@ namespace glbarcode
 		void clear();
 
 
+		/**
+		 * Reserve storage for drawing primitives.
+		 *
+		 * May be used by build() implementations that know how many primitives they will add.
+		 *
+		 * @param[in] n Number of drawing primitives
+		 */
+		void reservePrimitives( std::size_t n );
+
+
 		/**
 		 * Add line drawing primitive
 		 *
@@ -125,7 +125,8 @@ namespace glbarcode
 		 * Vectorize encoded data
 		 *
 		 * Optional virtual method to convert encoded data into a list of drawing
-		 * primitives which can later be rendered.
+		 * primitives which can later be rendered.  The default implementation
+		 * merges runs of dark cells into as few boxes as practical.
 		 *
 		 * @param[in]     encodedData Data to vectorize
 		 * @param[in,out] w           Requested width of barcode (0 = auto size), vectorize will overwrite with actual width
@@ -130,4 +130,79 @@ namespace glbarcode
 		return mH;
 	}
 
+
+
+	void DrawingPrimitiveBuffer::clear()
+	{
+		mPrimitives.clear();
+		mTexts.clear();
+	}
+
+
+	void DrawingPrimitiveBuffer::reserve( std::size_t n )
+	{
+		mPrimitives.reserve( n );
+	}
+
+
+	std::size_t DrawingPrimitiveBuffer::size() const
+	{
+		return mPrimitives.size();
+	}
+
+
+	bool DrawingPrimitiveBuffer::empty() const
+	{
+		return mPrimitives.empty();
+	}
+
+
+	DrawingPrimitiveBuffer::const_iterator DrawingPrimitiveBuffer::begin() const
+	{
+		return mPrimitives.begin();
+	}
+
+
+	DrawingPrimitiveBuffer::const_iterator DrawingPrimitiveBuffer::end() const
+	{
+		return mPrimitives.end();
+	}
+
+
+	const std::string& DrawingPrimitiveBuffer::text( const Primitive& primitive ) const
+	{
+		return mTexts[primitive.textIndex];
+	}
+
+
+	void DrawingPrimitiveBuffer::addLine( double x, double y, double w, double h )
+	{
+		mPrimitives.push_back( { Type::LINE, x, y, w, h, 0 } );
+	}
+
+
+	void DrawingPrimitiveBuffer::addBox( double x, double y, double w, double h )
+	{
+		mPrimitives.push_back( { Type::BOX, x, y, w, h, 0 } );
+	}
+
+
+	void DrawingPrimitiveBuffer::addText( double x, double y, double size, const std::string& text )
+	{
+		mPrimitives.push_back( { Type::TEXT, x, y, 0, size, mTexts.size() } );
+		mTexts.push_back( text );
+	}
+
+
+	void DrawingPrimitiveBuffer::addRing( double x, double y, double r, double w )
+	{
+		mPrimitives.push_back( { Type::RING, x, y, w, r, 0 } );
+	}
+
+
+	void DrawingPrimitiveBuffer::addHexagon( double x, double y, double h )
+	{
+		mPrimitives.push_back( { Type::HEXAGON, x, y, 0, h, 0 } );
+	}
+
 }
@@ -22,7 +22,9 @@
 #define glbarcode_DrawingPrimitives_h
 
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 
 namespace glbarcode
@@ -254,6 +256,118 @@ namespace glbarcode
 		double  mH;    /**< Height of hexagon (points). */
 	};
 
+
+
+	/**
+	 * @class DrawingPrimitiveBuffer DrawingPrimitives.h glbarcode/DrawingPrimitives.h
+	 *
+	 * A contiguous buffer of drawing primitives.
+	 *
+	 * Primitives are stored by value as type-tagged records, so building a barcode does not
+	 * allocate each primitive individually and rendering walks the buffer linearly.  Storage
+	 * is kept by clear(), so rebuilding a barcode reuses it.
+	 */
+	class DrawingPrimitiveBuffer
+	{
+	public:
+		/**
+		 * Primitive type
+		 */
+		enum class Type { LINE, BOX, TEXT, RING, HEXAGON };
+
+		/**
+		 * A single drawing primitive record.
+		 *
+		 * Field usage by type:
+		 *   - LINE, BOX: w and h are the width and height
+		 *   - TEXT:      h is the font size, text() gets the text
+		 *   - RING:      h is the radius, w is the line width
+		 *   - HEXAGON:   h is the height
+		 */
+		struct Primitive
+		{
+			Type        type;       /**< Primitive type. */
+			double      x;          /**< X coordinate of primitive's origin (points). */
+			double      y;          /**< Y coordinate of primitive's origin (points). */
+			double      w;          /**< Width (points). */
+			double      h;          /**< Height, radius or font size (points). */
+			std::size_t textIndex;  /**< Index of text, TEXT only. */
+		};
+
+		/**
+		 * Const iterator over primitives
+		 */
+		typedef std::vector<Primitive>::const_iterator const_iterator;
+
+		/**
+		 * Remove all primitives, keeping allocated storage.
+		 */
+		void clear();
+
+		/**
+		 * Reserve storage for n primitives.
+		 *
+		 * @param[in] n Number of primitives
+		 */
+		void reserve( std::size_t n );
+
+		/**
+		 * Get number of primitives.
+		 */
+		std::size_t size() const;
+
+		/**
+		 * Is buffer empty?
+		 */
+		bool empty() const;
+
+		/**
+		 * Get iterator to first primitive.
+		 */
+		const_iterator begin() const;
+
+		/**
+		 * Get iterator past last primitive.
+		 */
+		const_iterator end() const;
+
+		/**
+		 * Get text of a TEXT primitive.
+		 *
+		 * @param[in] primitive A TEXT primitive from this buffer
+		 */
+		const std::string& text( const Primitive& primitive ) const;
+
+		/**
+		 * Add line primitive.  See DrawingPrimitiveLine.
+		 */
+		void addLine( double x, double y, double w, double h );
+
+		/**
+		 * Add box primitive.  See DrawingPrimitiveBox.
+		 */
+		void addBox( double x, double y, double w, double h );
+
+		/**
+		 * Add text primitive.  See DrawingPrimitiveText.
+		 */
+		void addText( double x, double y, double size, const std::string& text );
+
+		/**
+		 * Add ring primitive.  See DrawingPrimitiveRing.
+		 */
+		void addRing( double x, double y, double r, double w );
+
+		/**
+		 * Add hexagon primitive.  See DrawingPrimitiveHexagon.
+		 */
+		void addHexagon( double x, double y, double h );
+
+	private:
+		std::vector<Primitive>    mPrimitives;  /**< Primitive records. */
+		std::vector<std::string>  mTexts;       /**< Texts of TEXT primitives. */
+	};
+
 }
 
 
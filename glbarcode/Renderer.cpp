@@ -59,3 +59,35 @@ void glbarcode::Renderer::render( double w, double h, const std::list<DrawingPri
 
 	drawEnd();
 }
+
+
+void glbarcode::Renderer::render( double w, double h, const DrawingPrimitiveBuffer& primitives )
+{
+	drawBegin( w, h );
+
+	DrawingPrimitiveBuffer::const_iterator primitive;
+
+	for ( primitive = primitives.begin(); primitive != primitives.end(); primitive++ )
+	{
+		switch ( primitive->type )
+		{
+		case DrawingPrimitiveBuffer::Type::LINE:
+			drawLine( primitive->x, primitive->y, primitive->w, primitive->h );
+			break;
+		case DrawingPrimitiveBuffer::Type::BOX:
+			drawBox( primitive->x, primitive->y, primitive->w, primitive->h );
+			break;
+		case DrawingPrimitiveBuffer::Type::TEXT:
+			drawText( primitive->x, primitive->y, primitive->h, primitives.text( *primitive ) );
+			break;
+		case DrawingPrimitiveBuffer::Type::RING:
+			drawRing( primitive->x, primitive->y, primitive->h, primitive->w );
+			break;
+		case DrawingPrimitiveBuffer::Type::HEXAGON:
+			drawHexagon( primitive->x, primitive->y, primitive->h );
+			break;
+		}
+	}
+
+	drawEnd();
+}
@@ -68,6 +68,16 @@ namespace glbarcode
 		void render( double w, double h, const std::list<DrawingPrimitive*>& primitives );
 
 
+		/**
+		 * Render buffer of primitives.
+		 *
+		 * @param[in] w          Width of barcode bounding box (points)
+		 * @param[in] h          Height of barcode bounding box (points)
+		 * @param[in] primitives Buffer of drawing primitives
+		 */
+		void render( double w, double h, const DrawingPrimitiveBuffer& primitives );
+
+
 	protected:
 		/**
 		 * Draw begin.
@@ -180,16 +180,17 @@ namespace glabels
 		{
 			QColor value = QColor( 192, 192, 192, 128 );
 			
+			int iColumn = mIsField ? mColumn.column( record, mKey ) : -1;
+
 			bool haveRecordField = mIsField && record &&
-				record->contains(mKey) &&
-				!record->value(mKey).isEmpty();
+				!record->valueAt(iColumn).isEmpty();
 			bool haveVariable = mIsField && variables &&
 				variables->contains(mKey) &&
 				!(*variables)[mKey].value().isEmpty();
 
 			if ( haveRecordField )
 			{
-				value = QColor( record->value(mKey) );
+				value = QColor( record->valueAt(iColumn) );
 			}
 			else if ( haveVariable )
 			{
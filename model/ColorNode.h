@@ -22,6 +22,7 @@
 #define model_ColorNode_h
 
 
+#include "ColumnBinding.h"
 #include "Variables.h"
 #include "merge/Record.h"
 
@@ -108,6 +109,8 @@ namespace glabels
 			QColor  mColor;
 			QString mKey;
 
+			mutable ColumnBinding mColumn;
+
 		};
 
 	}
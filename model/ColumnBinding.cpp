@@ -0,0 +1,62 @@
+/*  ColumnBinding.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ColumnBinding.h"
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Constructor
+		///
+		ColumnBinding::ColumnBinding()
+			: mSerial(0), mSize(0), mColumn(-1)
+		{
+			// empty
+		}
+
+
+		///
+		/// Get column of key in record (-1 if unknown)
+		///
+		int ColumnBinding::column( const merge::Record* record, const QString& key )
+		{
+			if ( !record )
+			{
+				return -1;
+			}
+
+			const merge::KeyTable* keyTable = record->keyTable();
+			if ( (keyTable->serial() != mSerial) || (keyTable->size() != mSize) || (key != mKey) )
+			{
+				mKey    = key;
+				mSerial = keyTable->serial();
+				mSize   = keyTable->size();
+				mColumn = keyTable->column( key );
+			}
+
+			return mColumn;
+		}
+
+	}
+}
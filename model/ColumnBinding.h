@@ -0,0 +1,76 @@
+/*  ColumnBinding.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef model_ColumnBinding_h
+#define model_ColumnBinding_h
+
+
+#include "merge/Record.h"
+
+#include <QString>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Column Binding
+		///
+		/// Remembers which column of a merge record's key table holds a given key,
+		/// so that repeated lookups against records of the same source reduce to an
+		/// index.  The binding is refreshed whenever the key table or key changes.
+		///
+		/// A binding is not shared between threads; each copy keeps its own state.
+		///
+		class ColumnBinding
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			ColumnBinding();
+
+
+			/////////////////////////////////
+			// Methods
+			/////////////////////////////////
+		public:
+			int column( const merge::Record* record, const QString& key );
+
+
+			/////////////////////////////////
+			// Private Data
+			/////////////////////////////////
+		private:
+			QString mKey;
+			int     mSerial;
+			int     mSize;
+			int     mColumn;
+
+		};
+
+	}
+}
+
+
+#endif // model_ColumnBinding_h
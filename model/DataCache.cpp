@@ -45,7 +45,7 @@ namespace glabels
 					{
 						if ( const QImage* image = imageObject->image() )
 						{
-							addImage( filenameNode.data(), *image );
+							addImage( filenameNode.data(), *image, imageObject->imageData() );
 						}
 						else
 						{
@@ -73,9 +73,23 @@ namespace glabels
 		}
 
 
-		void DataCache::addImage( const QString& name, const QImage& image )
+		QByteArray DataCache::getImageData( const QString& name ) const
+		{
+			return mImageDataMap.value( name );
+		}
+
+
+		void DataCache::addImage( const QString& name, const QImage& image, const QByteArray& data )
 		{
 			mImageMap[ name ] = image;
+			if ( data.isEmpty() )
+			{
+				mImageDataMap.remove( name );
+			}
+			else
+			{
+				mImageDataMap[ name ] = data;
+			}
 		}
 
 
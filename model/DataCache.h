@@ -39,7 +39,8 @@ namespace glabels
 
 			bool hasImage( const QString& name ) const;
 			QImage getImage( const QString& name ) const;
-			void addImage( const QString& name, const QImage& image );
+			QByteArray getImageData( const QString& name ) const;
+			void addImage( const QString& name, const QImage& image, const QByteArray& data = QByteArray() );
 			QList<QString> imageNames() const;
 
 			bool hasSvg( const QString& name ) const;
@@ -50,6 +51,7 @@ namespace glabels
 		
 		private:
 			QMap<QString,QImage> mImageMap;
+			QMap<QString,QByteArray> mImageDataMap;  // Encoded PNG, if known
 			QMap<QString,QByteArray> mSvgMap;
 
 		};
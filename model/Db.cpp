@@ -21,6 +21,7 @@
 #include "Db.h"
 
 #include "Config.h"
+#include "DbSnapshot.h"
 #include "StrUtil.h"
 #include "FileUtil.h"
 #include "Settings.h"
@@ -28,8 +29,12 @@
 #include "XmlPaperParser.h"
 #include "XmlTemplateParser.h"
 #include "XmlTemplateCreator.h"
+#include "XmlUtil.h"
 #include "XmlVendorParser.h"
 
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVector>
 #include <QtDebug>
 #include <QtGlobal>
 
@@ -47,11 +52,47 @@ namespace glabels
 		namespace
 		{
 			const QString    empty = "";
+
+			const QString    snapshotFileName = "system-templates.db";
 	
 			bool partNameLessThan( const Template *a, const Template *b )
 			{
 				return StrUtil::comparePartNames( a->name(), b->name() ) < 0;
 			}
+
+
+			///
+			/// Templates file, read but not yet registered
+			///
+			struct TemplateFile
+			{
+				QString                         fileName;
+				bool                            isUserDefined;
+				bool                            ok;
+				QList<XmlTemplateParser::Entry> entries;
+			};
+
+
+			///
+			/// Worker task to read a templates file
+			///
+			class TemplateFileReader : public QRunnable
+			{
+			public:
+				TemplateFileReader( TemplateFile* file ) : mFile(file)
+				{
+				}
+
+				void run() override
+				{
+					mFile->ok = XmlTemplateParser().readFile( mFile->fileName,
+					                                          mFile->isUserDefined,
+					                                          mFile->entries );
+				}
+
+			private:
+				TemplateFile* mFile;
+			};
 		}
 
 
@@ -68,12 +109,18 @@ namespace glabels
 		QStringList      Db::mVendorNames;
 		QList<Template*> Db::mTemplates;
 
+		QHash<QString,Paper*>             Db::mPaperIndexById;
+		QHash<QString,Paper*>             Db::mPaperIndexByName;
+		QHash<QString,Category*>          Db::mCategoryIndexById;
+		QHash<QString,Category*>          Db::mCategoryIndexByName;
+		QHash<QString,Vendor*>            Db::mVendorIndexByName;
+		QHash<QString,Template*>          Db::mTemplateIndexByName;
+		QHash<Db::BrandPart,Template*>    Db::mTemplateIndexByBrandPart;
+
 	
 		Db::Db()
 		{
-			readPapers();
-			readCategories();
-			readVendors();
+			readSystemDb();
 			readTemplates();
 		}
 
@@ -152,6 +199,12 @@ namespace glabels
 				mPapers << paper;
 				mPaperIds << paper->id();
 				mPaperNames << paper->name();
+
+				mPaperIndexById.insert( paper->id(), paper );
+				if ( !mPaperIndexByName.contains( paper->name() ) )
+				{
+					mPaperIndexByName.insert( paper->name(), paper );
+				}
 			}
 			else
 			{
@@ -168,12 +221,10 @@ namespace glabels
 				return mPapers.first();
 			}
 
-			foreach ( Paper *paper, mPapers )
+			const Paper *paper = mPaperIndexByName.value( name, nullptr );
+			if ( paper != nullptr )
 			{
-				if ( paper->name() == name )
-				{
-					return paper;
-				}
+				return paper;
 			}
 
 			qWarning() << "Unknown paper name: " << name;
@@ -189,12 +240,10 @@ namespace glabels
 				return mPapers.first();
 			}
 
-			foreach ( Paper *paper, mPapers )
+			const Paper *paper = mPaperIndexById.value( id, nullptr );
+			if ( paper != nullptr )
 			{
-				if ( paper->id() == id )
-				{
-					return paper;
-				}
+				return paper;
 			}
 
 			qWarning() << "Unknown paper ID: " << id;
@@ -254,15 +303,7 @@ namespace glabels
 
 		bool Db::isPaperIdKnown( const QString& id )
 		{
-			foreach ( Paper *paper, mPapers )
-			{
-				if ( paper->id() == id )
-				{
-					return true;
-				}
-			}
-
-			return false;
+			return mPaperIndexById.contains( id );
 		}
 
 
@@ -273,6 +314,12 @@ namespace glabels
 				mCategories << category;
 				mCategoryIds << category->id();
 				mCategoryNames << category->name();
+
+				mCategoryIndexById.insert( category->id(), category );
+				if ( !mCategoryIndexByName.contains( category->name() ) )
+				{
+					mCategoryIndexByName.insert( category->name(), category );
+				}
 			}
 			else
 			{
@@ -289,12 +336,10 @@ namespace glabels
 				return mCategories.first();
 			}
 
-			foreach ( Category *category, mCategories )
+			const Category *category = mCategoryIndexByName.value( name, nullptr );
+			if ( category != nullptr )
 			{
-				if ( category->name() == name )
-				{
-					return category;
-				}
+				return category;
 			}
 
 			qWarning() << "Unknown category name: \"%s\"." << name;
@@ -310,12 +355,10 @@ namespace glabels
 				return mCategories.first();
 			}
 
-			foreach ( Category *category, mCategories )
+			const Category *category = mCategoryIndexById.value( id, nullptr );
+			if ( category != nullptr )
 			{
-				if ( category->id() == id )
-				{
-					return category;
-				}
+				return category;
 			}
 
 			qWarning() << "Unknown category ID: " << id;
@@ -357,15 +400,7 @@ namespace glabels
 
 		bool Db::isCategoryIdKnown( const QString& id )
 		{
-			foreach ( Category *category, mCategories )
-			{
-				if ( category->id() == id )
-				{
-					return true;
-				}
-			}
-
-			return false;
+			return mCategoryIndexById.contains( id );
 		}
 
 
@@ -375,6 +410,8 @@ namespace glabels
 			{
 				mVendors << vendor;
 				mVendorNames << vendor->name();
+
+				mVendorIndexByName.insert( vendor->name(), vendor );
 			}
 			else
 			{
@@ -391,12 +428,10 @@ namespace glabels
 				return mVendors.first();
 			}
 
-			foreach ( Vendor *vendor, mVendors )
+			const Vendor *vendor = mVendorIndexByName.value( name, nullptr );
+			if ( vendor != nullptr )
 			{
-				if ( vendor->name() == name )
-				{
-					return vendor;
-				}
+				return vendor;
 			}
 
 			qWarning() << "Unknown vendor name: " << name;
@@ -422,15 +457,7 @@ namespace glabels
 
 		bool Db::isVendorNameKnown( const QString& name )
 		{
-			foreach ( Vendor *vendor, mVendors )
-			{
-				if ( vendor->name() == name )
-				{
-					return true;
-				}
-			}
-
-			return false;
+			return mVendorIndexByName.contains( name );
 		}
 
 
@@ -439,6 +466,12 @@ namespace glabels
 			if ( !isTemplateKnown( tmplate->brand(), tmplate->part() ) )
 			{
 				mTemplates << tmplate;
+
+				mTemplateIndexByBrandPart.insert( BrandPart( tmplate->brand(), tmplate->part() ), tmplate );
+				if ( !mTemplateIndexByName.contains( tmplate->name() ) )
+				{
+					mTemplateIndexByName.insert( tmplate->name(), tmplate );
+				}
 			}
 			else
 			{
@@ -455,12 +488,10 @@ namespace glabels
 				return mTemplates.first();
 			}
 
-			foreach ( Template *tmplate, mTemplates )
+			const Template *tmplate = mTemplateIndexByName.value( name, nullptr );
+			if ( tmplate != nullptr )
 			{
-				if ( tmplate->name() == name )
-				{
-					return tmplate;
-				}
+				return tmplate;
 			}
 
 			qWarning() << "Unknown template name: " << name;
@@ -476,12 +507,10 @@ namespace glabels
 				return mTemplates.first();
 			}
 
-			foreach ( Template *tmplate, mTemplates )
+			const Template *tmplate = mTemplateIndexByBrandPart.value( BrandPart( brand, part ), nullptr );
+			if ( tmplate != nullptr )
 			{
-				if ( (tmplate->brand() == brand) && (tmplate->part() == part) )
-				{
-					return tmplate;
-				}
+				return tmplate;
 			}
 
 			qWarning() << "Unknown template brand, part: " << brand << ", " << part;
@@ -491,31 +520,16 @@ namespace glabels
 
 		bool Db::isTemplateKnown( const QString& brand, const QString& part )
 		{
-			foreach ( Template *tmplate, mTemplates )
-			{
-				if ( (tmplate->brand() == brand) && (tmplate->part() == part) )
-				{
-					return true;
-				}
-			}
-
-			return false;
+			return mTemplateIndexByBrandPart.contains( BrandPart( brand, part ) );
 		}
 
 
 		bool Db::isSystemTemplateKnown( const QString& brand, const QString& part )
 		{
-			foreach ( Template *tmplate, mTemplates )
-			{
-				if ( (tmplate->brand() == brand) &&
-				     (tmplate->part() == part)   &&
-				     !tmplate->isUserDefined() )
-				{
-					return true;
-				}
-			}
+			// Brand and part are unique, so at most one template can match
+			const Template *tmplate = mTemplateIndexByBrandPart.value( BrandPart( brand, part ), nullptr );
 
-			return false;
+			return (tmplate != nullptr) && !tmplate->isUserDefined();
 		}
 
 
@@ -572,20 +586,28 @@ namespace glabels
 
 		void Db::deleteUserTemplateByBrandPart( const QString& brand, const QString& part )
 		{
-			Template* tmplate;
-			foreach ( Template *candidate, mTemplates )
+			Template* tmplate = mTemplateIndexByBrandPart.value( BrandPart( brand, part ), nullptr );
+
+			if ( tmplate && tmplate->isUserDefined() )
 			{
-				if ( candidate->isUserDefined() &&
-				     (candidate->brand() == brand) && (candidate->part() == part) )
+				mTemplates.removeOne( tmplate );
+
+				mTemplateIndexByBrandPart.remove( BrandPart( brand, part ) );
+				if ( mTemplateIndexByName.value( tmplate->name() ) == tmplate )
 				{
-					tmplate = candidate;
-					break;
+					mTemplateIndexByName.remove( tmplate->name() );
+
+					// Fall back to any other template of the same name
+					foreach ( Template *other, mTemplates )
+					{
+						if ( other->name() == tmplate->name() )
+						{
+							mTemplateIndexByName.insert( other->name(), other );
+							break;
+						}
+					}
 				}
-			}
 
-			if ( tmplate )
-			{
-				mTemplates.removeOne( tmplate );
 				delete tmplate;
 
 				QString filename = userTemplateFilename( brand, part );
@@ -658,6 +680,24 @@ namespace glabels
 		}
 
 
+		void Db::readSystemDb()
+		{
+			// The system database rarely changes, so prefer a binary snapshot of it
+			DbSnapshot snapshot( FileUtil::systemTemplatesDir(),
+			                     FileUtil::cacheDir().absoluteFilePath( snapshotFileName ) );
+
+			if ( !snapshot.load() )
+			{
+				readPapers();
+				readCategories();
+				readVendors();
+				readTemplatesFromDir( FileUtil::systemTemplatesDir(), false );
+
+				snapshot.save();
+			}
+		}
+
+
 		void Db::readPapers()
 		{
 			readPapersFromDir( FileUtil::systemTemplatesDir() );
@@ -720,7 +760,6 @@ namespace glabels
 
 		void Db::readTemplates()
 		{
-			readTemplatesFromDir( FileUtil::systemTemplatesDir(), false );
 			readTemplatesFromDir( FileUtil::manualUserTemplatesDir(), false );
 			readTemplatesFromDir( FileUtil::userTemplatesDir(), true );
 
@@ -733,11 +772,33 @@ namespace glabels
 			QStringList filters;
 			filters << "*-templates.xml" << "*.template";
 
-			XmlTemplateParser parser;
+			QStringList fileNames = dir.entryList( filters, QDir::Files );
+
+			//
+			// Read files in parallel, then register their templates serially, in
+			// file order, so that the result is the same as reading them one by one.
+			//
+			XmlUtil::init(); // Not thread-safe, so do it before starting workers
+
+			QVector<TemplateFile> files( fileNames.size() );
 
-			foreach ( QString fileName, dir.entryList( filters, QDir::Files ) )
+			QThreadPool pool;
+			for ( int i = 0; i < fileNames.size(); i++ )
 			{
-				parser.readFile( dir.absoluteFilePath( fileName ), isUserDefined );
+				files[i].fileName      = dir.absoluteFilePath( fileNames[i] );
+				files[i].isUserDefined = isUserDefined;
+				files[i].ok            = false;
+				pool.start( new TemplateFileReader( &files[i] ) );
+			}
+			pool.waitForDone();
+
+			XmlTemplateParser parser;
+			foreach ( const TemplateFile& file, files )
+			{
+				if ( file.ok )
+				{
+					parser.registerEntries( file.entries, isUserDefined );
+				}
 			}
 		}
 
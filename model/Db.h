@@ -29,7 +29,9 @@
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QHash>
 #include <QList>
+#include <QPair>
 #include <QString>
 
 
@@ -106,6 +108,8 @@ namespace glabels
 		private:
 			static QDir systemTemplatesDir();
 
+			static void readSystemDb();
+
 			static void readPapers();
 			static void readPapersFromDir( const QDir& dir );
 
@@ -133,6 +137,17 @@ namespace glabels
 
 			static QList<Template*> mTemplates;
 
+			// Lookup indexes, kept in sync with the above lists
+			typedef QPair<QString,QString> BrandPart;
+
+			static QHash<QString,Paper*>       mPaperIndexById;
+			static QHash<QString,Paper*>       mPaperIndexByName;
+			static QHash<QString,Category*>    mCategoryIndexById;
+			static QHash<QString,Category*>    mCategoryIndexByName;
+			static QHash<QString,Vendor*>      mVendorIndexByName;
+			static QHash<QString,Template*>    mTemplateIndexByName;
+			static QHash<BrandPart,Template*>  mTemplateIndexByBrandPart;
+
 		};
 
 	}
@@ -0,0 +1,848 @@
+/*  DbSnapshot.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DbSnapshot.h"
+
+#include "Db.h"
+#include "FrameCd.h"
+#include "FrameContinuous.h"
+#include "FrameEllipse.h"
+#include "FramePath.h"
+#include "FrameRect.h"
+#include "FrameRound.h"
+#include "Markup.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QSaveFile>
+#include <QtDebug>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const quint32 snapshotMagic   = 0x474C4442; // "GLDB"
+			const quint32 snapshotVersion = 1;
+
+			const QDataStream::Version streamVersion = QDataStream::Qt_5_4;
+
+			enum FrameType
+			{
+				FRAME_RECT = 1,
+				FRAME_ELLIPSE,
+				FRAME_ROUND,
+				FRAME_CD,
+				FRAME_PATH,
+				FRAME_CONTINUOUS
+			};
+
+			enum MarkupType
+			{
+				MARKUP_MARGIN = 1,
+				MARKUP_LINE,
+				MARKUP_CIRCLE,
+				MARKUP_RECT,
+				MARKUP_ELLIPSE
+			};
+
+
+			///
+			/// Template read from a snapshot
+			///
+			/// Templates are only created once their papers are registered, since a
+			/// template looks up its paper to tell ISO and US sizes.
+			///
+			struct TemplateData
+			{
+				QString       brand;
+				QString       part;
+				QString       description;
+				QString       paperId;
+				Distance      pageWidth;
+				Distance      pageHeight;
+				Distance      rollWidth;
+				QString       equivPart;
+				QString       productUrl;
+				QStringList   categoryIds;
+				QList<Frame*> frames;
+			};
+
+
+			///
+			/// Database contents read from a snapshot, not yet registered with Db
+			///
+			/// Anything still held when reading fails is deleted, so that Db is
+			/// left untouched for the XML sources to be read instead.
+			///
+			struct Payload
+			{
+				QList<Paper*>       papers;
+				QList<Category*>    categories;
+				QList<Vendor*>      vendors;
+				QList<TemplateData> templates;
+
+				~Payload()
+				{
+					qDeleteAll( papers );
+					qDeleteAll( categories );
+					qDeleteAll( vendors );
+					foreach ( const TemplateData& data, templates )
+					{
+						qDeleteAll( data.frames );
+					}
+				}
+			};
+
+
+			void writeDistance( QDataStream& out, const Distance& d )
+			{
+				out << d.pt();
+			}
+
+
+			Distance readDistance( QDataStream& in )
+			{
+				double dPts = 0;
+				in >> dPts;
+				return Distance::pt( dPts );
+			}
+
+
+			void writeMarkup( QDataStream& out, const Markup* markup )
+			{
+				if ( const auto* markupMargin = dynamic_cast<const MarkupMargin*>(markup) )
+				{
+					out << quint8( MARKUP_MARGIN );
+					writeDistance( out, markupMargin->xSize() );
+					writeDistance( out, markupMargin->ySize() );
+				}
+				else if ( const auto* markupLine = dynamic_cast<const MarkupLine*>(markup) )
+				{
+					out << quint8( MARKUP_LINE );
+					writeDistance( out, markupLine->x1() );
+					writeDistance( out, markupLine->y1() );
+					writeDistance( out, markupLine->x2() );
+					writeDistance( out, markupLine->y2() );
+				}
+				else if ( const auto* markupCircle = dynamic_cast<const MarkupCircle*>(markup) )
+				{
+					out << quint8( MARKUP_CIRCLE );
+					writeDistance( out, markupCircle->x0() );
+					writeDistance( out, markupCircle->y0() );
+					writeDistance( out, markupCircle->r() );
+				}
+				else if ( const auto* markupRect = dynamic_cast<const MarkupRect*>(markup) )
+				{
+					out << quint8( MARKUP_RECT );
+					writeDistance( out, markupRect->x1() );
+					writeDistance( out, markupRect->y1() );
+					writeDistance( out, markupRect->w() );
+					writeDistance( out, markupRect->h() );
+					writeDistance( out, markupRect->r() );
+				}
+				else if ( const auto* markupEllipse = dynamic_cast<const MarkupEllipse*>(markup) )
+				{
+					out << quint8( MARKUP_ELLIPSE );
+					writeDistance( out, markupEllipse->x1() );
+					writeDistance( out, markupEllipse->y1() );
+					writeDistance( out, markupEllipse->w() );
+					writeDistance( out, markupEllipse->h() );
+				}
+				else
+				{
+					Q_ASSERT_X( false, "DbSnapshot::writeMarkup", "Invalid markup type." );
+				}
+			}
+
+
+			Markup* readMarkup( QDataStream& in )
+			{
+				quint8 type = 0;
+				in >> type;
+
+				switch ( type )
+				{
+
+				case MARKUP_MARGIN:
+				{
+					Distance xSize = readDistance( in );
+					Distance ySize = readDistance( in );
+					return new MarkupMargin( xSize, ySize );
+				}
+
+				case MARKUP_LINE:
+				{
+					Distance x1 = readDistance( in );
+					Distance y1 = readDistance( in );
+					Distance x2 = readDistance( in );
+					Distance y2 = readDistance( in );
+					return new MarkupLine( x1, y1, x2, y2 );
+				}
+
+				case MARKUP_CIRCLE:
+				{
+					Distance x0 = readDistance( in );
+					Distance y0 = readDistance( in );
+					Distance r  = readDistance( in );
+					return new MarkupCircle( x0, y0, r );
+				}
+
+				case MARKUP_RECT:
+				{
+					Distance x1 = readDistance( in );
+					Distance y1 = readDistance( in );
+					Distance w  = readDistance( in );
+					Distance h  = readDistance( in );
+					Distance r  = readDistance( in );
+					return new MarkupRect( x1, y1, w, h, r );
+				}
+
+				case MARKUP_ELLIPSE:
+				{
+					Distance x1 = readDistance( in );
+					Distance y1 = readDistance( in );
+					Distance w  = readDistance( in );
+					Distance h  = readDistance( in );
+					return new MarkupEllipse( x1, y1, w, h );
+				}
+
+				default:
+					return nullptr;
+
+				}
+			}
+
+
+			void writeFrame( QDataStream& out, const Frame* frame )
+			{
+				if ( const auto* frameRect = dynamic_cast<const FrameRect*>(frame) )
+				{
+					out << quint8( FRAME_RECT ) << frame->id();
+					writeDistance( out, frameRect->w() );
+					writeDistance( out, frameRect->h() );
+					writeDistance( out, frameRect->r() );
+					writeDistance( out, frameRect->xWaste() );
+					writeDistance( out, frameRect->yWaste() );
+				}
+				else if ( const auto* frameEllipse = dynamic_cast<const FrameEllipse*>(frame) )
+				{
+					out << quint8( FRAME_ELLIPSE ) << frame->id();
+					writeDistance( out, frameEllipse->w() );
+					writeDistance( out, frameEllipse->h() );
+					writeDistance( out, frameEllipse->waste() );
+				}
+				else if ( const auto* frameRound = dynamic_cast<const FrameRound*>(frame) )
+				{
+					out << quint8( FRAME_ROUND ) << frame->id();
+					writeDistance( out, frameRound->r() );
+					writeDistance( out, frameRound->waste() );
+				}
+				else if ( const auto* frameCd = dynamic_cast<const FrameCd*>(frame) )
+				{
+					out << quint8( FRAME_CD ) << frame->id();
+					writeDistance( out, frameCd->r1() );
+					writeDistance( out, frameCd->r2() );
+					writeDistance( out, frameCd->w() );
+					writeDistance( out, frameCd->h() );
+					writeDistance( out, frameCd->waste() );
+				}
+				else if ( const auto* framePath = dynamic_cast<const FramePath*>(frame) )
+				{
+					out << quint8( FRAME_PATH ) << frame->id();
+					out << framePath->path();
+					writeDistance( out, framePath->xWaste() );
+					writeDistance( out, framePath->yWaste() );
+					out << framePath->originalUnits().toIdString();
+				}
+				else if ( const auto* frameContinuous = dynamic_cast<const FrameContinuous*>(frame) )
+				{
+					out << quint8( FRAME_CONTINUOUS ) << frame->id();
+					writeDistance( out, frameContinuous->w() );
+					writeDistance( out, frameContinuous->hMin() );
+					writeDistance( out, frameContinuous->hMax() );
+					writeDistance( out, frameContinuous->hDefault() );
+					writeDistance( out, frameContinuous->h() );
+				}
+				else
+				{
+					Q_ASSERT_X( false, "DbSnapshot::writeFrame", "Invalid frame type." );
+				}
+
+				out << quint32( frame->layouts().size() );
+				foreach ( const Layout& layout, frame->layouts() )
+				{
+					out << qint32( layout.nx() ) << qint32( layout.ny() );
+					writeDistance( out, layout.x0() );
+					writeDistance( out, layout.y0() );
+					writeDistance( out, layout.dx() );
+					writeDistance( out, layout.dy() );
+				}
+
+				out << quint32( frame->markups().size() );
+				foreach ( const Markup* markup, frame->markups() )
+				{
+					writeMarkup( out, markup );
+				}
+			}
+
+
+			Frame* readFrame( QDataStream& in )
+			{
+				quint8  type = 0;
+				QString id;
+				in >> type >> id;
+
+				Frame* frame = nullptr;
+
+				switch ( type )
+				{
+
+				case FRAME_RECT:
+				{
+					Distance w      = readDistance( in );
+					Distance h      = readDistance( in );
+					Distance r      = readDistance( in );
+					Distance xWaste = readDistance( in );
+					Distance yWaste = readDistance( in );
+					frame = new FrameRect( w, h, r, xWaste, yWaste, id );
+					break;
+				}
+
+				case FRAME_ELLIPSE:
+				{
+					Distance w     = readDistance( in );
+					Distance h     = readDistance( in );
+					Distance waste = readDistance( in );
+					frame = new FrameEllipse( w, h, waste, id );
+					break;
+				}
+
+				case FRAME_ROUND:
+				{
+					Distance r     = readDistance( in );
+					Distance waste = readDistance( in );
+					frame = new FrameRound( r, waste, id );
+					break;
+				}
+
+				case FRAME_CD:
+				{
+					Distance r1    = readDistance( in );
+					Distance r2    = readDistance( in );
+					Distance w     = readDistance( in );
+					Distance h     = readDistance( in );
+					Distance waste = readDistance( in );
+					frame = new FrameCd( r1, r2, w, h, waste, id );
+					break;
+				}
+
+				case FRAME_PATH:
+				{
+					QPainterPath path;
+					in >> path;
+					Distance xWaste = readDistance( in );
+					Distance yWaste = readDistance( in );
+					QString  unitsId;
+					in >> unitsId;
+					frame = new FramePath( path, xWaste, yWaste, Units( unitsId ), id );
+					break;
+				}
+
+				case FRAME_CONTINUOUS:
+				{
+					Distance w        = readDistance( in );
+					Distance hMin     = readDistance( in );
+					Distance hMax     = readDistance( in );
+					Distance hDefault = readDistance( in );
+					Distance h        = readDistance( in );
+					frame = new FrameContinuous( w, hMin, hMax, hDefault, id );
+					frame->setH( h );
+					break;
+				}
+
+				default:
+					return nullptr;
+
+				}
+
+				quint32 nLayouts = 0;
+				in >> nLayouts;
+				for ( quint32 i = 0; (i < nLayouts) && (in.status() == QDataStream::Ok); i++ )
+				{
+					qint32 nX = 0;
+					qint32 nY = 0;
+					in >> nX >> nY;
+					Distance x0 = readDistance( in );
+					Distance y0 = readDistance( in );
+					Distance dX = readDistance( in );
+					Distance dY = readDistance( in );
+					frame->addLayout( Layout( nX, nY, x0, y0, dX, dY ) );
+				}
+
+				quint32 nMarkups = 0;
+				in >> nMarkups;
+				for ( quint32 i = 0; (i < nMarkups) && (in.status() == QDataStream::Ok); i++ )
+				{
+					Markup* markup = readMarkup( in );
+					if ( !markup )
+					{
+						delete frame;
+						return nullptr;
+					}
+					frame->addMarkup( markup );
+				}
+
+				if ( in.status() != QDataStream::Ok )
+				{
+					delete frame;
+					return nullptr;
+				}
+
+				return frame;
+			}
+
+		}
+
+
+		///
+		/// Constructor
+		///
+		DbSnapshot::DbSnapshot( const QDir& sourceDir, const QString& fileName )
+			: mSourceDir(sourceDir), mFileName(fileName)
+		{
+			// empty
+		}
+
+
+		///
+		/// Load snapshot, if still valid
+		///
+		/// The snapshot file is mapped into memory rather than read.
+		///
+		bool DbSnapshot::load() const
+		{
+			QFile file( mFileName );
+			if ( !file.open( QIODevice::ReadOnly ) )
+			{
+				return false;
+			}
+
+			qint64 size = file.size();
+			const uchar* data = file.map( 0, size );
+			if ( !data )
+			{
+				return false;
+			}
+			QByteArray bytes = QByteArray::fromRawData( reinterpret_cast<const char*>( data ), int( size ) );
+
+			QDataStream in( bytes );
+			in.setVersion( streamVersion );
+
+			//
+			// Header
+			//
+			quint32 magic   = 0;
+			quint32 version = 0;
+			in >> magic >> version;
+			if ( (in.status() != QDataStream::Ok) || (magic != snapshotMagic) || (version != snapshotVersion) )
+			{
+				return false;
+			}
+
+			QString locale;
+			QString sourceDir;
+			in >> locale >> sourceDir;
+			if ( (locale != QLocale().name()) || (sourceDir != mSourceDir.absolutePath()) )
+			{
+				return false;
+			}
+
+			quint32 nSources = 0;
+			in >> nSources;
+			QList<SourceFile> sources;
+			for ( quint32 i = 0; (i < nSources) && (in.status() == QDataStream::Ok); i++ )
+			{
+				SourceFile source;
+				in >> source.name >> source.size >> source.mtime >> source.hash;
+				sources << source;
+			}
+
+			QByteArray digest;
+			quint64    payloadSize = 0;
+			in >> digest >> payloadSize;
+			if ( in.status() != QDataStream::Ok )
+			{
+				return false;
+			}
+
+			bool refresh = false;
+			if ( !checkSources( sources, refresh ) )
+			{
+				return false;
+			}
+
+			//
+			// Payload
+			//
+			qint64 offset = in.device()->pos();
+			if ( offset + qint64( payloadSize ) != size )
+			{
+				return false;
+			}
+
+			QByteArray payload = QByteArray::fromRawData( bytes.constData() + offset, int( payloadSize ) );
+			if ( QCryptographicHash::hash( payload, QCryptographicHash::Md5 ) != digest )
+			{
+				return false;
+			}
+
+			QDataStream payloadIn( payload );
+			payloadIn.setVersion( streamVersion );
+			if ( !readPayload( payloadIn ) )
+			{
+				qWarning() << "Error: invalid template database snapshot" << mFileName;
+				return false;
+			}
+
+			if ( refresh )
+			{
+				save(); // Sources touched, but unchanged: record new modification times
+			}
+
+			return true;
+		}
+
+
+		///
+		/// Save snapshot of current database contents
+		///
+		bool DbSnapshot::save() const
+		{
+			QByteArray payload = writePayload();
+
+			QSaveFile file( mFileName );
+			if ( !file.open( QIODevice::WriteOnly ) )
+			{
+				qWarning() << "Error: cannot write template database snapshot" << mFileName;
+				return false;
+			}
+
+			QDataStream out( &file );
+			out.setVersion( streamVersion );
+
+			out << snapshotMagic << snapshotVersion;
+			out << QLocale().name() << mSourceDir.absolutePath();
+
+			QList<SourceFile> sources = scanSources( true );
+			out << quint32( sources.size() );
+			foreach ( const SourceFile& source, sources )
+			{
+				out << source.name << source.size << source.mtime << source.hash;
+			}
+
+			out << QCryptographicHash::hash( payload, QCryptographicHash::Md5 );
+			out << quint64( payload.size() );
+			out.writeRawData( payload.constData(), payload.size() );
+
+			return (out.status() == QDataStream::Ok) && file.commit();
+		}
+
+
+		///
+		/// Scan source files
+		///
+		QList<DbSnapshot::SourceFile> DbSnapshot::scanSources( bool withHashes ) const
+		{
+			QList<SourceFile> sources;
+
+			foreach ( const QFileInfo& fileInfo, mSourceDir.entryInfoList( QDir::Files, QDir::Name ) )
+			{
+				SourceFile source;
+				source.name  = fileInfo.fileName();
+				source.size  = fileInfo.size();
+				source.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+				if ( withHashes )
+				{
+					source.hash = hashSource( source.name );
+				}
+				sources << source;
+			}
+
+			return sources;
+		}
+
+
+		///
+		/// Hash contents of source file
+		///
+		QByteArray DbSnapshot::hashSource( const QString& name ) const
+		{
+			QCryptographicHash hash( QCryptographicHash::Md5 );
+
+			QFile file( mSourceDir.absoluteFilePath( name ) );
+			if ( file.open( QIODevice::ReadOnly ) )
+			{
+				hash.addData( &file );
+			}
+
+			return hash.result();
+		}
+
+
+		///
+		/// Do source files match those recorded in snapshot?
+		///
+		/// Sets refresh, if any modification times have changed without a change
+		/// in content.
+		///
+		bool DbSnapshot::checkSources( const QList<SourceFile>& sources, bool& refresh ) const
+		{
+			QList<SourceFile> currentSources = scanSources( false );
+			if ( currentSources.size() != sources.size() )
+			{
+				return false;
+			}
+
+			for ( int i = 0; i < sources.size(); i++ )
+			{
+				if ( (currentSources[i].name != sources[i].name) ||
+				     (currentSources[i].size != sources[i].size) )
+				{
+					return false;
+				}
+
+				if ( currentSources[i].mtime != sources[i].mtime )
+				{
+					if ( hashSource( sources[i].name ) != sources[i].hash )
+					{
+						return false;
+					}
+					refresh = true;
+				}
+			}
+
+			return true;
+		}
+
+
+		///
+		/// Serialize current database contents
+		///
+		QByteArray DbSnapshot::writePayload()
+		{
+			QByteArray payload;
+			QDataStream out( &payload, QIODevice::WriteOnly );
+			out.setVersion( streamVersion );
+
+			out << quint32( Db::papers().size() );
+			foreach ( const Paper* paper, Db::papers() )
+			{
+				out << paper->id() << paper->name();
+				writeDistance( out, paper->width() );
+				writeDistance( out, paper->height() );
+				out << paper->pwgSize();
+			}
+
+			out << quint32( Db::categories().size() );
+			foreach ( const Category* category, Db::categories() )
+			{
+				out << category->id() << category->name();
+			}
+
+			out << quint32( Db::vendors().size() );
+			foreach ( const Vendor* vendor, Db::vendors() )
+			{
+				out << vendor->name() << vendor->url();
+			}
+
+			out << quint32( Db::templates().size() );
+			foreach ( const Template* tmplate, Db::templates() )
+			{
+				out << tmplate->brand() << tmplate->part() << tmplate->description() << tmplate->paperId();
+				writeDistance( out, tmplate->pageWidth() );
+				writeDistance( out, tmplate->pageHeight() );
+				writeDistance( out, tmplate->rollWidth() );
+				out << tmplate->equivPart() << tmplate->productUrl() << tmplate->categoryIds();
+
+				out << quint32( tmplate->frames().size() );
+				foreach ( const Frame* frame, tmplate->frames() )
+				{
+					writeFrame( out, frame );
+				}
+			}
+
+			return payload;
+		}
+
+
+		///
+		/// Deserialize and register database contents
+		///
+		/// Nothing is registered unless the whole payload is read.
+		///
+		bool DbSnapshot::readPayload( QDataStream& in )
+		{
+			Payload payload;
+
+			quint32 nPapers = 0;
+			in >> nPapers;
+			for ( quint32 i = 0; i < nPapers; i++ )
+			{
+				QString id;
+				QString name;
+				QString pwgSize;
+				in >> id >> name;
+				Distance width  = readDistance( in );
+				Distance height = readDistance( in );
+				in >> pwgSize;
+				if ( in.status() != QDataStream::Ok )
+				{
+					return false;
+				}
+
+				payload.papers << new Paper( id, name, width, height, pwgSize );
+			}
+
+			quint32 nCategories = 0;
+			in >> nCategories;
+			for ( quint32 i = 0; i < nCategories; i++ )
+			{
+				QString id;
+				QString name;
+				in >> id >> name;
+				if ( in.status() != QDataStream::Ok )
+				{
+					return false;
+				}
+
+				payload.categories << new Category( id, name );
+			}
+
+			quint32 nVendors = 0;
+			in >> nVendors;
+			for ( quint32 i = 0; i < nVendors; i++ )
+			{
+				QString name;
+				QString url;
+				in >> name >> url;
+				if ( in.status() != QDataStream::Ok )
+				{
+					return false;
+				}
+
+				payload.vendors << new Vendor( name, url );
+			}
+
+			quint32 nTemplates = 0;
+			in >> nTemplates;
+			for ( quint32 i = 0; i < nTemplates; i++ )
+			{
+				TemplateData data;
+
+				in >> data.brand >> data.part >> data.description >> data.paperId;
+				data.pageWidth  = readDistance( in );
+				data.pageHeight = readDistance( in );
+				data.rollWidth  = readDistance( in );
+				in >> data.equivPart >> data.productUrl >> data.categoryIds;
+				if ( in.status() != QDataStream::Ok )
+				{
+					return false;
+				}
+
+				quint32 nFrames = 0;
+				in >> nFrames;
+				for ( quint32 iFrame = 0; iFrame < nFrames; iFrame++ )
+				{
+					Frame* frame = readFrame( in );
+					if ( !frame )
+					{
+						qDeleteAll( data.frames );
+						return false;
+					}
+					data.frames << frame;
+				}
+
+				payload.templates << data;
+			}
+
+			if ( in.status() != QDataStream::Ok )
+			{
+				return false;
+			}
+
+			foreach ( Paper* paper, payload.papers )
+			{
+				Db::registerPaper( paper );
+			}
+			foreach ( Category* category, payload.categories )
+			{
+				Db::registerCategory( category );
+			}
+			foreach ( Vendor* vendor, payload.vendors )
+			{
+				Db::registerVendor( vendor );
+			}
+
+			// Now owned by Db
+			payload.papers.clear();
+			payload.categories.clear();
+			payload.vendors.clear();
+
+			// Papers are now known, so templates can be created
+			foreach ( const TemplateData& data, payload.templates )
+			{
+				auto* tmplate = new Template( data.brand, data.part, data.description, data.paperId,
+				                              data.pageWidth, data.pageHeight, data.rollWidth );
+				if ( !data.equivPart.isEmpty() )
+				{
+					tmplate->setEquivPart( data.equivPart );
+				}
+				if ( !data.productUrl.isEmpty() )
+				{
+					tmplate->setProductUrl( data.productUrl );
+				}
+				foreach ( const QString& categoryId, data.categoryIds )
+				{
+					tmplate->addCategory( categoryId );
+				}
+				foreach ( Frame* frame, data.frames )
+				{
+					tmplate->addFrame( frame );
+				}
+
+				Db::registerTemplate( tmplate );
+			}
+			payload.templates.clear();
+
+			return true;
+		}
+
+	}
+}
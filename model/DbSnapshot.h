@@ -0,0 +1,103 @@
+/*  DbSnapshot.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef model_DbSnapshot_h
+#define model_DbSnapshot_h
+
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDir>
+#include <QList>
+#include <QString>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Template Database Snapshot
+		///
+		/// A binary copy of the papers, categories, vendors and templates read from
+		/// a templates directory.  Loading a snapshot registers its contents with
+		/// Db, exactly as if the XML sources had been parsed.  A snapshot is only
+		/// used if it was written for the same directory and locale, and every
+		/// source file still has the same size and modification time (or, failing
+		/// that, the same content hash).
+		///
+		class DbSnapshot
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			DbSnapshot( const QDir& sourceDir, const QString& fileName );
+
+
+			/////////////////////////////////
+			// Methods
+			/////////////////////////////////
+		public:
+			bool load() const;
+			bool save() const;
+
+
+			/////////////////////////////////
+			// Private types
+			/////////////////////////////////
+		private:
+			struct SourceFile
+			{
+				QString    name;
+				qint64     size;
+				qint64     mtime;
+				QByteArray hash;
+			};
+
+
+			/////////////////////////////////
+			// Private methods
+			/////////////////////////////////
+		private:
+			QList<SourceFile> scanSources( bool withHashes ) const;
+			QByteArray hashSource( const QString& name ) const;
+			bool checkSources( const QList<SourceFile>& sources, bool& refresh ) const;
+
+			static QByteArray writePayload();
+			static bool readPayload( QDataStream& in );
+
+
+			/////////////////////////////////
+			// Private data
+			/////////////////////////////////
+		private:
+			QDir    mSourceDir;
+			QString mFileName;
+
+		};
+
+	}
+}
+
+
+#endif // model_DbSnapshot_h
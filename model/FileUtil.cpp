@@ -86,6 +86,17 @@ namespace glabels
 		}
 		
 
+		QDir FileUtil::cacheDir()
+		{
+			// Location for cached data, shared by all gLabels programs
+			QDir dir( QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) );
+			dir.mkpath( "glabels-qt" );
+			dir.cd( "glabels-qt" );
+
+			return dir;
+		}
+		
+
 		QDir FileUtil::translationsDir()
 		{
 			QDir dir;
@@ -39,6 +39,7 @@ namespace glabels
 			QDir systemTemplatesDir();
 			QDir manualUserTemplatesDir();
 			QDir userTemplatesDir();
+			QDir cacheDir();
 
 			QDir translationsDir();
 
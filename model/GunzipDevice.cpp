@@ -0,0 +1,176 @@
+/*  GunzipDevice.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GunzipDevice.h"
+
+#if HAVE_ZLIB
+
+#include <limits>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const int inBufferSize = 64 * 1024;
+		}
+
+
+		///
+		/// Constructor
+		///
+		GunzipDevice::GunzipDevice( QIODevice* source )
+			: mSource(source), mStreamEnd(false)
+		{
+			mStream.zalloc = Z_NULL;
+			mStream.zfree  = Z_NULL;
+			mStream.opaque = Z_NULL;
+		}
+
+
+		///
+		/// Destructor
+		///
+		GunzipDevice::~GunzipDevice()
+		{
+			close();
+		}
+
+
+		///
+		/// Open device, only ReadOnly is supported
+		///
+		bool GunzipDevice::open( OpenMode mode )
+		{
+			if ( (mode & ReadWrite) != ReadOnly || !mSource->isReadable() )
+			{
+				setErrorString( "Source not readable" );
+				return false;
+			}
+
+			mInBuffer.resize( inBufferSize );
+			mStream.next_in  = Z_NULL;
+			mStream.avail_in = 0;
+			mStreamEnd       = false;
+
+			if ( inflateInit2( &mStream, MAX_WBITS + 16 ) != Z_OK ) // gzip decoding
+			{
+				setErrorString( "Cannot initialize zlib" );
+				return false;
+			}
+
+			return QIODevice::open( mode );
+		}
+
+
+		///
+		/// Close device
+		///
+		void GunzipDevice::close()
+		{
+			if ( isOpen() )
+			{
+				inflateEnd( &mStream );
+				mInBuffer.clear();
+				QIODevice::close();
+			}
+		}
+
+
+		///
+		/// Is sequential?
+		///
+		bool GunzipDevice::isSequential() const
+		{
+			return true;
+		}
+
+
+		///
+		/// At end of inflated data?
+		///
+		bool GunzipDevice::atEnd() const
+		{
+			return mStreamEnd && QIODevice::atEnd();
+		}
+
+
+		///
+		/// Inflate up to maxSize bytes
+		///
+		qint64 GunzipDevice::readData( char* data, qint64 maxSize )
+		{
+			qint64 size = qMin( maxSize, qint64(std::numeric_limits<uInt>::max()) );
+
+			mStream.next_out  = reinterpret_cast<Bytef*>( data );
+			mStream.avail_out = uInt(size);
+
+			while ( (mStream.avail_out > 0) && !mStreamEnd )
+			{
+				if ( mStream.avail_in == 0 )
+				{
+					qint64 n = mSource->read( mInBuffer.data(), mInBuffer.size() );
+					if ( n <= 0 )
+					{
+						if ( mStream.avail_out < uInt(size) )
+						{
+							break; // Return what we have, fail on next read
+						}
+						setErrorString( "Compressed data is truncated" );
+						return -1;
+					}
+					mStream.next_in  = reinterpret_cast<Bytef*>( mInBuffer.data() );
+					mStream.avail_in = uInt(n);
+				}
+
+				int ret = inflate( &mStream, Z_NO_FLUSH );
+				if ( ret == Z_STREAM_END )
+				{
+					mStreamEnd = true;
+				}
+				else if ( (ret != Z_OK) && (ret != Z_BUF_ERROR) )
+				{
+					setErrorString( mStream.msg ? QString( mStream.msg ) : QString( "Corrupt compressed data" ) );
+					return -1;
+				}
+			}
+
+			return size - mStream.avail_out;
+		}
+
+
+		///
+		/// Writing is not supported
+		///
+		qint64 GunzipDevice::writeData( const char*, qint64 )
+		{
+			return -1;
+		}
+
+	}
+}
+
+#endif // HAVE_ZLIB
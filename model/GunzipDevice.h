@@ -0,0 +1,87 @@
+/*  GunzipDevice.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef model_GunzipDevice_h
+#define model_GunzipDevice_h
+
+
+#if HAVE_ZLIB
+
+#include <QByteArray>
+#include <QIODevice>
+
+#include <zlib.h>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Read-only device inflating a gzip stream read from another device
+		///
+		/// Lets readers such as QXmlStreamReader consume compressed files
+		/// without holding the whole inflated document in memory.
+		///
+		class GunzipDevice : public QIODevice
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			GunzipDevice( QIODevice* source );
+			~GunzipDevice() override;
+
+
+			/////////////////////////////////
+			// QIODevice Implementation
+			/////////////////////////////////
+		public:
+			bool open( OpenMode mode ) override;
+			void close() override;
+			bool isSequential() const override;
+			bool atEnd() const override;
+
+		protected:
+			qint64 readData( char* data, qint64 maxSize ) override;
+			qint64 writeData( const char* data, qint64 maxSize ) override;
+
+
+			/////////////////////////////////
+			// Private Data
+			/////////////////////////////////
+		private:
+			QIODevice* mSource;
+			QByteArray mInBuffer;
+			z_stream   mStream;
+			bool       mStreamEnd;
+
+		};
+
+	}
+}
+
+#endif // HAVE_ZLIB
+
+
+#endif // model_GunzipDevice_h
@@ -0,0 +1,176 @@
+/*  GzipDevice.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GzipDevice.h"
+
+#if HAVE_ZLIB
+
+#include <QtDebug>
+
+#include <limits>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const int outBufferSize = 256 * 1024;
+		}
+
+
+		///
+		/// Constructor
+		///
+		GzipDevice::GzipDevice( QIODevice* sink, int level )
+			: mSink(sink), mLevel(level)
+		{
+			mStream.zalloc = Z_NULL;
+			mStream.zfree  = Z_NULL;
+			mStream.opaque = Z_NULL;
+		}
+
+
+		///
+		/// Destructor
+		///
+		GzipDevice::~GzipDevice()
+		{
+			close();
+		}
+
+
+		///
+		/// Open device, only WriteOnly is supported
+		///
+		bool GzipDevice::open( OpenMode mode )
+		{
+			if ( (mode & ReadWrite) != WriteOnly || !mSink->isWritable() )
+			{
+				setErrorString( "Sink not writable" );
+				return false;
+			}
+
+			mOutBuffer.resize( outBufferSize );
+
+			if ( deflateInit2( &mStream, mLevel, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY ) != Z_OK ) // gzip encoding
+			{
+				setErrorString( "Cannot initialize zlib" );
+				return false;
+			}
+
+			return QIODevice::open( mode );
+		}
+
+
+		///
+		/// Close device, completing the gzip stream
+		///
+		void GzipDevice::close()
+		{
+			if ( isOpen() )
+			{
+				mStream.next_in  = Z_NULL;
+				mStream.avail_in = 0;
+				if ( !deflateToSink( Z_FINISH ) )
+				{
+					qWarning() << "Error: Cannot complete compressed data:" << errorString();
+				}
+
+				deflateEnd( &mStream );
+				mOutBuffer.clear();
+				QIODevice::close();
+			}
+		}
+
+
+		///
+		/// Is sequential?
+		///
+		bool GzipDevice::isSequential() const
+		{
+			return true;
+		}
+
+
+		///
+		/// Reading is not supported
+		///
+		qint64 GzipDevice::readData( char*, qint64 )
+		{
+			return -1;
+		}
+
+
+		///
+		/// Compress data to sink
+		///
+		qint64 GzipDevice::writeData( const char* data, qint64 maxSize )
+		{
+			qint64 size = qMin( maxSize, qint64(std::numeric_limits<uInt>::max()) );
+
+			mStream.next_in  = reinterpret_cast<Bytef*>( const_cast<char*>( data ) );
+			mStream.avail_in = uInt(size);
+
+			if ( !deflateToSink( Z_NO_FLUSH ) )
+			{
+				return -1;
+			}
+
+			return size;
+		}
+
+
+		///
+		/// Run deflate() until all pending input is consumed, writing output to sink
+		///
+		bool GzipDevice::deflateToSink( int flush )
+		{
+			do
+			{
+				mStream.next_out  = reinterpret_cast<Bytef*>( mOutBuffer.data() );
+				mStream.avail_out = uInt(mOutBuffer.size());
+
+				if ( deflate( &mStream, flush ) == Z_STREAM_ERROR )
+				{
+					setErrorString( "Corrupt compression state" );
+					return false;
+				}
+
+				qint64 n = mOutBuffer.size() - mStream.avail_out;
+				if ( (n > 0) && (mSink->write( mOutBuffer.constData(), n ) != n) )
+				{
+					setErrorString( mSink->errorString() );
+					return false;
+				}
+			} while ( mStream.avail_out == 0 );
+
+			return true;
+		}
+
+	}
+}
+
+#endif // HAVE_ZLIB
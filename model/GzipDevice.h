@@ -0,0 +1,93 @@
+/*  GzipDevice.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef model_GzipDevice_h
+#define model_GzipDevice_h
+
+
+#if HAVE_ZLIB
+
+#include <QByteArray>
+#include <QIODevice>
+
+#include <zlib.h>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		///
+		/// Write-only device gzip compressing data to another device
+		///
+		/// Compresses as data is written, so the uncompressed document is never
+		/// held in memory.  The gzip stream is completed by close().
+		///
+		class GzipDevice : public QIODevice
+		{
+
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			GzipDevice( QIODevice* sink, int level = Z_DEFAULT_COMPRESSION );
+			~GzipDevice() override;
+
+
+			/////////////////////////////////
+			// QIODevice Implementation
+			/////////////////////////////////
+		public:
+			bool open( OpenMode mode ) override;
+			void close() override;
+			bool isSequential() const override;
+
+		protected:
+			qint64 readData( char* data, qint64 maxSize ) override;
+			qint64 writeData( const char* data, qint64 maxSize ) override;
+
+
+			/////////////////////////////////
+			// Private Methods
+			/////////////////////////////////
+		private:
+			bool deflateToSink( int flush );
+
+
+			/////////////////////////////////
+			// Private Data
+			/////////////////////////////////
+		private:
+			QIODevice* mSink;
+			int        mLevel;
+			QByteArray mOutBuffer;
+			z_stream   mStream;
+
+		};
+
+	}
+}
+
+#endif // HAVE_ZLIB
+
+
+#endif // model_GzipDevice_h
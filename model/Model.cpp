@@ -34,6 +34,7 @@
 #include <QClipboard>
 #include <QFileInfo>
 #include <QMimeData>
+#include <QSet>
 #include <QtDebug>
 
 
@@ -86,6 +87,22 @@ namespace glabels
 		/// Save model state
 		///
 		Model* Model::save() const
+		{
+			auto* savedModel = saveProperties();
+
+			savedModel->restore( this );
+
+			return savedModel;
+		}
+
+
+		///
+		/// Save model state, without objects
+		///
+		/// Objects are supplied again when restoring, e.g. by an undo history that
+		/// shares unchanged objects between saved states.
+		///
+		Model* Model::saveProperties() const
 		{
 			auto* savedModel = new Model( mMerge, mVariables ); // mMerge and mVariables shared between models
 
@@ -94,7 +111,11 @@ namespace glabels
 				qDebug() << "Model::save: Warning: called before mUntitledInstance has been initialized: untitled names will differ";
 			}
 
-			savedModel->restore( this );
+			savedModel->mUntitledInstance = mUntitledInstance;
+			savedModel->mModified         = mModified;
+			savedModel->mFileName         = mFileName;
+			savedModel->mTmplate          = mTmplate;
+			savedModel->mRotate           = mRotate;
 
 			return savedModel;
 		}
@@ -105,12 +126,35 @@ namespace glabels
 		///
 		void Model::restore( const Model *savedModel )
 		{
-			// Clear current object list
+			QList<ModelObject*> objects;
+			foreach ( ModelObject* savedObject, savedModel->mObjectList )
+			{
+				objects << savedObject->clone();
+			}
+
+			restore( savedModel, objects );
+		}
+
+
+		///
+		/// Restore model state, with given objects
+		///
+		/// The objects of savedModel are ignored.  Objects already in this model
+		/// are kept, if listed, or deleted.  Other listed objects are adopted.
+		///
+		void Model::restore( const Model *savedModel, const QList<ModelObject*>& objects )
+		{
+			// Delete objects that are not kept
+			QSet<ModelObject*> keptObjects = objects.toSet();
 			foreach ( ModelObject* object, mObjectList )
 			{
-				delete object;
+				if ( !keptObjects.contains( object ) )
+				{
+					delete object;
+				}
 			}
 			mObjectList.clear();
+			mObjectIndex.clear();
 
 			// Now copy state
 			mUntitledInstance = savedModel->mUntitledInstance;
@@ -119,15 +163,16 @@ namespace glabels
 			mTmplate          = savedModel->mTmplate;
 			mRotate           = savedModel->mRotate;
 
-			foreach ( ModelObject* savedObject, savedModel->mObjectList )
+			foreach ( ModelObject* object, objects )
 			{
-				ModelObject* object = savedObject->clone();
-		
-				object->setParent( this );
-				mObjectList << object;
+				if ( object->parent() != this )
+				{
+					object->setParent( this );
 
-				connect( object, SIGNAL(changed()), this, SLOT(onObjectChanged()) );
-				connect( object, SIGNAL(moved()), this, SLOT(onObjectMoved()) );
+					connect( object, SIGNAL(changed()), this, SLOT(onObjectChanged()) );
+					connect( object, SIGNAL(moved()), this, SLOT(onObjectMoved()) );
+				}
+				mObjectList << object;
 			}
 
 			// Emit signals based on potential changes
@@ -413,6 +458,7 @@ namespace glabels
 		{
 			object->setParent( this );
 			mObjectList << object;
+			mObjectIndex.clear();
 
 			connect( object, SIGNAL(changed()), this, SLOT(onObjectChanged()) );
 			connect( object, SIGNAL(moved()), this, SLOT(onObjectMoved()) );
@@ -430,6 +476,7 @@ namespace glabels
 		{
 			object->unselect();
 			mObjectList.removeOne( object );
+			mObjectIndex.clear();
 
 			disconnect( object, nullptr, this, nullptr );
 
@@ -448,9 +495,15 @@ namespace glabels
 		                              const Distance& x,
 		                              const Distance& y ) const
 		{
-			/* Search object list in reverse order.  I.e. from top to bottom. */
-			QList<ModelObject*>::const_iterator it = mObjectList.end();
-			while ( it != mObjectList.begin() )
+			if ( !mObjectIndex.isValid( scale ) )
+			{
+				mObjectIndex.build( mObjectList, scale );
+			}
+
+			/* Search candidates in reverse order.  I.e. from top to bottom. */
+			QList<ModelObject*> candidates = mObjectIndex.objectsAt( QPointF( x.pt(), y.pt() ) );
+			QList<ModelObject*>::const_iterator it = candidates.constEnd();
+			while ( it != candidates.constBegin() )
 			{
 				it--;
 				ModelObject* object = *it;
@@ -489,6 +542,7 @@ namespace glabels
 		///
 		void Model::onObjectChanged()
 		{
+			mObjectIndex.clear();
 			setModified();
 			emit changed();
 		}
@@ -499,6 +553,7 @@ namespace glabels
 		///
 		void Model::onObjectMoved()
 		{
+			mObjectIndex.clear();
 			setModified();
 			emit changed();
 		}
@@ -596,7 +651,13 @@ namespace glabels
 			Distance rX2 = max( region.x1(), region.x2() );
 			Distance rY2 = max( region.y1(), region.y2() );
 
-			foreach ( ModelObject* object, mObjectList )
+			if ( !mObjectIndex.isValid( mObjectIndex.scale() ) )
+			{
+				mObjectIndex.build( mObjectList, mObjectIndex.scale() );
+			}
+
+			QRectF rect( rX1.pt(), rY1.pt(), (rX2 - rX1).pt(), (rY2 - rY1).pt() );
+			foreach ( ModelObject* object, mObjectIndex.objectsIn( rect ) )
 			{
 				Region objectExtent = object->getExtent();
 
@@ -793,6 +854,7 @@ namespace glabels
 			{
 				mObjectList.push_back( object );
 			}
+			mObjectIndex.clear();
 
 			setModified();
 
@@ -817,6 +879,7 @@ namespace glabels
 			{
 				mObjectList.push_front( object );
 			}
+			mObjectIndex.clear();
 
 			setModified();
 
@@ -1524,5 +1587,23 @@ namespace glabels
 			}
 		}
 
+
+		///
+		/// Content key of label objects
+		///
+		/// Two labels with the same key draw identically.
+		///
+		QString Model::contentKey( merge::Record* record, Variables* variables ) const
+		{
+			QString key;
+
+			foreach ( ModelObject* object, mObjectList )
+			{
+				key += object->contentKey( record, variables ) + QChar(0x1E);
+			}
+
+			return key;
+		}
+
 	}
 }
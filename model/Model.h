@@ -22,6 +22,7 @@
 #define model_Model_h
 
 
+#include "ObjectIndex.h"
 #include "Settings.h"
 #include "Template.h"
 #include "Variables.h"
@@ -67,7 +68,9 @@ namespace glabels
 			// Save/restore model state
 			/////////////////////////////////
 			Model* save() const;
+			Model* saveProperties() const;
 			void restore( const Model *savedModel );
+			void restore( const Model *savedModel, const QList<ModelObject*>& objects );
 	
 
 			/////////////////////////////////
@@ -217,6 +220,9 @@ namespace glabels
 			           merge::Record* record,
 			           Variables*     variables ) const;
 
+			QString contentKey( merge::Record* record,
+			                    Variables*     variables ) const;
+
 		
 			/////////////////////////////////
 			// Slots
@@ -240,6 +246,7 @@ namespace glabels
 			bool                      mRotate;
 
 			QList<ModelObject*>       mObjectList;
+			mutable ObjectIndex       mObjectIndex;
 
 			Variables*                mVariables;
 			merge::Merge*             mMerge;
@@ -49,6 +49,8 @@ namespace glabels
 			const Distance pad = Distance::pt(4);
 			const Distance minW = Distance::pt(18);
 			const Distance minH = Distance::pt(18);
+
+			const int maxCachedBarcodes = 64;
 		}
 
 
@@ -78,6 +80,8 @@ namespace glabels
 			mEditorBarcode = nullptr;
 			mEditorDefaultBarcode = nullptr;
 
+			mBarcodeCache.setMaxCost( maxCachedBarcodes );
+
 			update(); // Initialize cached editor layouts
 		}
 
@@ -119,6 +123,8 @@ namespace glabels
 			mEditorBarcode = nullptr;
 			mEditorDefaultBarcode = nullptr;
 
+			mBarcodeCache.setMaxCost( maxCachedBarcodes );
+
 			update(); // Initialize cached editor layouts
 		}
 	
@@ -139,6 +145,8 @@ namespace glabels
 			mEditorBarcode = nullptr;
 			mEditorDefaultBarcode = nullptr;
 
+			mBarcodeCache.setMaxCost( maxCachedBarcodes );
+
 			update(); // Initialize cached editor layouts
 		}
 
@@ -307,6 +315,18 @@ namespace glabels
 		}
 
 
+		///
+		/// Content key
+		///
+		QString ModelBarcodeObject::contentKey( merge::Record* record,
+		                                        Variables*     variables ) const
+		{
+			return ModelObject::contentKey( record, variables )
+			       + QChar(0x1F) + QString::number( mBcColorNode.color( record, variables ).rgba(), 16 )
+			       + QChar(0x1F) + mBcData.expand( record, variables );
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -458,11 +478,31 @@ namespace glabels
 		{
 			painter->setPen( QPen( color ) );
 
-			glbarcode::Barcode* bc = glbarcode::Factory::createBarcode( mBcStyle.fullId().toStdString() );
-			bc->setChecksum(mBcChecksumFlag);
-			bc->setShowText(mBcTextFlag);
+			QString data = mBcData.expand( record, variables );
 
-			bc->build( mBcData.expand( record, variables ).toStdString(), mW.pt(), mH.pt() );
+			// Identical barcodes (repeated data, multiple copies) are only built once
+			QString key = mBcStyle.fullId()
+			       + QChar(0x1F) + (mBcChecksumFlag ? "c" : "")
+			       + QChar(0x1F) + (mBcTextFlag ? "t" : "")
+			       + QChar(0x1F) + QString::number( mW.pt(), 'g', 17 )
+			       + QChar(0x1F) + QString::number( mH.pt(), 'g', 17 )
+			       + QChar(0x1F) + data;
+
+			glbarcode::Barcode* bc = mBarcodeCache.object( key );
+			if ( !bc )
+			{
+				bc = glbarcode::Factory::createBarcode( mBcStyle.fullId().toStdString() );
+				if ( !bc )
+				{
+					return;
+				}
+				bc->setChecksum(mBcChecksumFlag);
+				bc->setShowText(mBcTextFlag);
+
+				bc->build( data.toStdString(), mW.pt(), mH.pt() );
+
+				mBarcodeCache.insert( key, bc ); // Cache takes ownership
+			}
 
 			glbarcode::QtRenderer renderer(painter);
 			bc->render( renderer );
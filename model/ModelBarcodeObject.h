@@ -28,6 +28,8 @@
 
 #include "glbarcode/Barcode.h"
 
+#include <QCache>
+
 
 namespace glabels
 {
@@ -126,6 +128,10 @@ namespace glabels
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
+		public:
+			QString contentKey( merge::Record* record,
+			                    Variables*     variables ) const override;
+
 		protected:
 			void drawShadow( QPainter*      painter,
 			                 bool           inEditor,
@@ -171,6 +177,8 @@ namespace glabels
 
 			glbarcode::Barcode* mEditorBarcode;
 			glbarcode::Barcode* mEditorDefaultBarcode;
+
+			mutable QCache<QString,glbarcode::Barcode> mBarcodeCache;
 		
 			QPainterPath mHoverPath;
 
@@ -24,12 +24,28 @@
 #include "Size.h"
 
 #include <QBrush>
+#include <QCache>
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 #include <QImage>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPaintDevice>
 #include <QPen>
 #include <QtDebug>
 
+#include <cmath>
+
+#if defined(__AVX2__)
+#define MODEL_IMAGE_USE_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MODEL_IMAGE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 
 namespace glabels
 {
@@ -50,13 +66,118 @@ namespace glabels
 			const QColor fillColor  = QColor( 224, 224, 224, 255 );
 			const QColor labelColor = QColor( 102, 102, 102, 255 );
 			const Distance pad = Distance::pt(2);
+			const QByteArray pngSignature( "\x89PNG\r\n\x1a\n" );
+
+			const int maxImageCacheCost = 256 * 1024; // KiB
+
+
+			///
+			/// Image or svg read from file, for merge field images
+			///
+			struct CachedImage
+			{
+				QImage     image;
+				QByteArray svg;
+			};
+
+
+			///
+			/// Cache of merge field images, shared by all threads
+			///
+			/// Images are implicitly shared and only read once cached, so copies can
+			/// be drawn by several threads.
+			///
+			QMutex                      imageCacheMutex;
+			QCache<QString,CachedImage> imageCache( maxImageCacheCost );
+
+
+			const int maxShadowCacheCost = 64 * 1024; // KiB
+
+
+			///
+			/// Cache of tinted shadow images, shared by all threads
+			///
+			QMutex                 shadowCacheMutex;
+			QCache<QString,QImage> shadowCache( maxShadowCacheCost );
+
+
+			///
+			/// Tint a scan line of ARGB32 pixels to rgb, scaling their alpha by a/255
+			///
+			void tintScanLine( const QRgb* src, QRgb* dst, int n, QRgb rgb, int a )
+			{
+				int i = 0;
+
+#if MODEL_IMAGE_USE_AVX2
+				const __m256i vRgb256 = _mm256_set1_epi32( int(rgb) );
+				const __m256i vA256   = _mm256_set1_epi32( a );
+				const __m256i vOne256 = _mm256_set1_epi32( 1 );
+
+				for ( ; (n - i) >= 8; i += 8 )
+				{
+					__m256i alpha = _mm256_srli_epi32( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + i ) ), 24 );
+					__m256i x     = _mm256_mullo_epi16( alpha, vA256 ); // Fits in the low 16 bits of each pixel
+
+					// x/255, exact for 0 <= x <= 255*255
+					x = _mm256_srli_epi32( _mm256_add_epi32( _mm256_add_epi32( x, vOne256 ), _mm256_srli_epi32( x, 8 ) ), 8 );
+
+					_mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + i ),
+					                     _mm256_or_si256( _mm256_slli_epi32( x, 24 ), vRgb256 ) );
+				}
+#endif
+
+#if MODEL_IMAGE_USE_SSE2
+				const __m128i vRgb = _mm_set1_epi32( int(rgb) );
+				const __m128i vA   = _mm_set1_epi32( a );
+				const __m128i vOne = _mm_set1_epi32( 1 );
+
+				for ( ; (n - i) >= 4; i += 4 )
+				{
+					__m128i alpha = _mm_srli_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) ), 24 );
+					__m128i x     = _mm_mullo_epi16( alpha, vA ); // Fits in the low 16 bits of each pixel
+
+					// x/255, exact for 0 <= x <= 255*255
+					x = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( x, vOne ), _mm_srli_epi32( x, 8 ) ), 8 );
+
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ),
+					                  _mm_or_si128( _mm_slli_epi32( x, 24 ), vRgb ) );
+				}
+#endif
+
+				for ( ; i < n; i++ )
+				{
+					dst[i] = rgb | (QRgb( (a*qAlpha( src[i] ))/255 ) << 24);
+				}
+			}
+
+
+			///
+			/// Size of rect in device pixels, independent of rotation
+			///
+			/// Returns an empty size when the final resolution is not known, e.g. when
+			/// recording into a QPicture that is replayed later at any scale.
+			///
+			QSize deviceSize( const QPainter* painter, const QRectF& rect )
+			{
+				QPaintDevice* device = painter->device();
+				if ( !device || (device->devType() == QInternal::Picture) )
+				{
+					return QSize();
+				}
+
+				QTransform t = painter->deviceTransform();
+				double sx = std::sqrt( t.m11()*t.m11() + t.m12()*t.m12() );
+				double sy = std::sqrt( t.m21()*t.m21() + t.m22()*t.m22() );
+
+				return QSize( int( std::ceil( rect.width()*sx ) ), int( std::ceil( rect.height()*sy ) ) );
+			}
 		}
 
 
 		///
 		/// Constructor
 		///
-		ModelImageObject::ModelImageObject() : mImage(nullptr), mSvgRenderer(nullptr)
+		ModelImageObject::ModelImageObject() : mImage(nullptr), mSvgRenderer(nullptr), mImageDataKey(0)
 		{
 			mOutline = new Outline( this );
 
@@ -115,6 +236,7 @@ namespace glabels
 
 			mImage = nullptr;
 			mSvgRenderer = nullptr;
+			mImageDataKey = 0;
 
 			loadImage();
 		}
@@ -159,6 +281,7 @@ namespace glabels
 			mImage = new QImage(image);
 			mFilenameNode = TextNode( false, filename );
 			mSvgRenderer = nullptr;
+			mImageDataKey = 0;
 		}
 
 
@@ -202,6 +325,7 @@ namespace glabels
 			mSvgRenderer = new QSvgRenderer( mSvg );
 			mFilenameNode = TextNode( false, filename );
 			mImage = nullptr;
+			mImageDataKey = 0;
 		}
 
 
@@ -228,6 +352,8 @@ namespace glabels
 				mSvgRenderer = nullptr;
 			}
 			mSvg = object->mSvg;
+			mImageData = object->mImageData;
+			mImageDataKey = object->mImageDataKey;
 		}
 
 
@@ -316,6 +442,7 @@ namespace glabels
 				}
 
 				mImage = new QImage(value);
+				mImageData.clear();
 				quint16 cs = qChecksum( (const char*)mImage->constBits(), mImage->byteCount() );
 				mFilenameNode = TextNode( false, QString("%image_%1%").arg( cs ) );
 
@@ -343,6 +470,7 @@ namespace glabels
 				}
 
 				mImage = new QImage(value);
+				mImageData.clear();
 				mFilenameNode = TextNode( false, name );
 
 				emit changed();
@@ -350,6 +478,37 @@ namespace glabels
 		}
 		
 
+		///
+		/// Image imageData Property Getter
+		///
+		/// Empty if the encoded source is unknown, or no longer matches the image.
+		///
+		QByteArray ModelImageObject::imageData() const
+		{
+			if ( mImage && (mImage->cacheKey() == mImageDataKey) )
+			{
+				return mImageData;
+			}
+			return QByteArray();
+		}
+
+
+		///
+		/// Image imageData Property Setter
+		///
+		/// Value must be the PNG encoding of the current image, e.g. as read from a
+		/// <Data> node, so it can be written back without re-encoding.
+		///
+		void ModelImageObject::setImageData( const QByteArray& value )
+		{
+			if ( mImage )
+			{
+				mImageData    = value;
+				mImageDataKey = mImage->cacheKey();
+			}
+		}
+
+
 		///
 		/// Image svg Property Getter
 		///
@@ -379,6 +538,7 @@ namespace glabels
 
 				mSvg = value;
 				mSvgRenderer = new QSvgRenderer( mSvg );
+				mImageData.clear();
 				mFilenameNode = TextNode( false, name );
 
 				emit changed();
@@ -410,6 +570,17 @@ namespace glabels
 		}
 
 
+		///
+		/// Content key
+		///
+		QString ModelImageObject::contentKey( merge::Record* record,
+		                                      Variables*     variables ) const
+		{
+			return ModelObject::contentKey( record, variables )
+			       + QChar(0x1F) + mFilenameNode.text( record, variables );
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -423,11 +594,9 @@ namespace glabels
 			QColor shadowColor = mShadowColorNode.color( record, variables );
 			shadowColor.setAlphaF( mShadowOpacity );
 
-			if ( mImage && mImage->hasAlphaChannel() && (mImage->depth() == 32) )
+			if ( mImage && mImage->hasAlphaChannel() )
 			{
-				QImage* shadowImage = createShadowImage( *mImage, shadowColor );
-				painter->drawImage( destRect, *shadowImage );
-				delete shadowImage;
+				painter->drawImage( destRect, shadowImage( *mImage, shadowColor ) );
 			}
 			else if ( mImage || mSvgRenderer || inEditor )
 			{
@@ -439,16 +608,13 @@ namespace glabels
 			else
 			{
 				QString filename = mFilenameNode.text( record, variables );
-				QImage* image;
-				QSvgRenderer* svgRenderer;
+				QImage image;
 				QByteArray svg;
-				if ( readImageFile( filename, image, svgRenderer, svg ) )
+				if ( readCachedImageFile( filename, deviceSize( painter, destRect ), image, svg ) )
 				{
-					if ( image && image->hasAlphaChannel() && (image->depth() == 32) )
+					if ( !image.isNull() && image.hasAlphaChannel() )
 					{
-						QImage* shadowImage = createShadowImage( *image, shadowColor );
-						painter->drawImage( destRect, *shadowImage );
-						delete shadowImage;
+						painter->drawImage( destRect, shadowImage( image, shadowColor ) );
 					}
 					else
 					{
@@ -457,14 +623,6 @@ namespace glabels
 
 						painter->drawRect( destRect );
 					}
-					if ( image )
-					{
-						delete image;
-					}
-					else
-					{
-						delete svgRenderer;
-					}
 				}
 			}
 		}
@@ -549,20 +707,18 @@ namespace glabels
 			else if ( mFilenameNode.isField() )
 			{
 				QString filename = mFilenameNode.text( record, variables );
-				QImage* image;
-				QSvgRenderer* svgRenderer;
+				QImage image;
 				QByteArray svg;
-				if ( readImageFile( filename, image, svgRenderer, svg ) )
+				if ( readCachedImageFile( filename, deviceSize( painter, destRect ), image, svg ) )
 				{
-					if ( image )
+					if ( !image.isNull() )
 					{
-						painter->drawImage( destRect, *image );
-						delete image;
+						painter->drawImage( destRect, image );
 					}
 					else
 					{
-						svgRenderer->render( painter, destRect );
-						delete svgRenderer;
+						QSvgRenderer svgRenderer( svg );
+						svgRenderer.render( painter, destRect );
 					}
 				}
 			}
@@ -596,12 +752,15 @@ namespace glabels
 				delete mSvgRenderer;
 				mSvgRenderer = nullptr;
 			}
+			mImageData.clear();
 
 			if ( !mFilenameNode.isField() )
 			{
 				QString filename = mFilenameNode.data();
-				if ( readImageFile( filename, mImage, mSvgRenderer, mSvg ) )
+				if ( readImageFile( filename, mImage, mSvgRenderer, mSvg, mImageData ) )
 				{
+					mImageDataKey = mImage ? mImage->cacheKey() : 0;
+
 					double aspectRatio = 0;
 					if ( mSvgRenderer )
 					{
@@ -639,22 +798,17 @@ namespace glabels
 		bool ModelImageObject::readImageFile( const QString& fileName,
 		                                      QImage*&       image,
 		                                      QSvgRenderer*& svgRenderer,
-		                                      QByteArray&    svg ) const
+		                                      QByteArray&    svg,
+		                                      QByteArray&    imageData ) const
 		{
 			image = nullptr;
 			svgRenderer = nullptr;
 			svg.clear();
+			imageData.clear();
 
 			if ( !fileName.isEmpty() )
 			{
-				QFileInfo fileInfo( fileName );
-				if ( fileInfo.isRelative() )
-				{
-					// Look for image file relative to project file 1st then CWD 2nd
-					auto* model = dynamic_cast<Model*>( parent() );
-					QDir::setSearchPaths( "images", {model ? model->dirPath() : "", QDir::currentPath()} );
-					fileInfo.setFile( QString("images:") + fileName );
-				}
+				QFileInfo fileInfo( findImageFile( fileName ) );
 
 				if ( fileInfo.isReadable() )
 				{
@@ -676,11 +830,27 @@ namespace glabels
 					}
 					else
 					{
-						image = new QImage( fileInfo.filePath() );
-						if ( image->isNull() )
+						QFile file( fileInfo.filePath() );
+						if ( file.open( QFile::ReadOnly ) )
 						{
-							delete image;
-							image = nullptr;
+							QByteArray data = file.readAll();
+							file.close();
+							image = new QImage( QImage::fromData( data ) );
+							if ( image->isNull() )
+							{
+								// Some formats are only recognized by suffix
+								image->load( fileInfo.filePath() );
+							}
+							if ( image->isNull() )
+							{
+								delete image;
+								image = nullptr;
+							}
+							else if ( data.startsWith( pngSignature ) )
+							{
+								// Keep PNG source, so it can be embedded without re-encoding
+								imageData = data;
+							}
 						}
 					}
 				}
@@ -691,27 +861,155 @@ namespace glabels
 
 
 		///
-		/// Create shadow image
+		/// Find image file, looking for relative names in project dir 1st then CWD 2nd
 		///
-		QImage* ModelImageObject::createShadowImage( const QImage& image,
-		                                             const QColor& color ) const
+		QString ModelImageObject::findImageFile( const QString& fileName ) const
 		{
-			int r = color.red();
-			int g = color.green();
-			int b = color.blue();
-			int a = color.alpha();
-		
-			auto* shadow = new QImage( image );
-			for ( int iy = 0; iy < shadow->height(); iy++ )
+			if ( QFileInfo( fileName ).isAbsolute() )
 			{
-				auto* scanLine = (QRgb*)shadow->scanLine( iy );
-		
-				for ( int ix = 0; ix < shadow->width(); ix++ )
+				return fileName;
+			}
+
+			auto* model = dynamic_cast<Model*>( parent() );
+			if ( model )
+			{
+				QString filePath = QDir( model->dirPath() ).filePath( fileName );
+				if ( QFileInfo::exists( filePath ) )
+				{
+					return filePath;
+				}
+			}
+
+			return QDir::current().filePath( fileName );
+		}
+
+
+		///
+		/// Read an image or svg file through the merge field image cache
+		///
+		/// Entries are keyed by resolved path and modification time, so edited files
+		/// are re-read.  Large images are pre-scaled to deviceSize.
+		///
+		bool ModelImageObject::readCachedImageFile( const QString& fileName,
+		                                            const QSize&   deviceSize,
+		                                            QImage&        image,
+		                                            QByteArray&    svg ) const
+		{
+			image = QImage();
+			svg.clear();
+
+			if ( fileName.isEmpty() )
+			{
+				return false;
+			}
+
+			QFileInfo fileInfo( findImageFile( fileName ) );
+			if ( !fileInfo.isReadable() )
+			{
+				return false;
+			}
+
+			bool isSvg = fileInfo.suffix().toLower() == "svg";
+
+			QString key = fileInfo.absoluteFilePath()
+				+ QChar(0x1F) + QString::number( fileInfo.lastModified().toMSecsSinceEpoch() )
+				+ QChar(0x1F) + QString::number( fileInfo.size() );
+			if ( !isSvg )
+			{
+				key += QChar(0x1F) + QString::number( deviceSize.width() )
+					+ QChar(0x1F) + QString::number( deviceSize.height() );
+			}
+
+			{
+				QMutexLocker locker( &imageCacheMutex );
+				if ( CachedImage* cachedImage = imageCache.object( key ) )
 				{
-					scanLine[ix] = qRgba( r, g, b, (a*qAlpha(scanLine[ix]))/255 );
+					image = cachedImage->image;
+					svg   = cachedImage->svg;
+					return true;
 				}
 			}
 
+			QImage*       fileImage;
+			QSvgRenderer* svgRenderer;
+			QByteArray    imageData;
+			if ( !readImageFile( fileInfo.absoluteFilePath(), fileImage, svgRenderer, svg, imageData ) )
+			{
+				return false;
+			}
+
+			int cost;
+			if ( fileImage )
+			{
+				image = *fileImage;
+				delete fileImage;
+
+				// Pre-scale large images, never larger than drawn on device
+				if ( (image.depth() == 32) && !deviceSize.isEmpty() &&
+				     (image.width() > deviceSize.width()) && (image.height() > deviceSize.height()) )
+				{
+					image = image.scaled( deviceSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+				}
+				cost = image.byteCount() / 1024 + 1;
+			}
+			else
+			{
+				delete svgRenderer;
+				cost = svg.size() / 1024 + 1;
+			}
+
+			QMutexLocker locker( &imageCacheMutex );
+			imageCache.insert( key, new CachedImage{ image, svg }, cost );
+
+			return true;
+		}
+
+
+		///
+		/// Get shadow image, cached per image and color
+		///
+		QImage ModelImageObject::shadowImage( const QImage& image,
+		                                      const QColor& color ) const
+		{
+			// Copies of an image share its cache key, which changes when it is modified
+			QString key = QString::number( image.cacheKey() )
+				+ QChar(0x1F) + QString::number( color.rgba() );
+
+			{
+				QMutexLocker locker( &shadowCacheMutex );
+				if ( QImage* shadow = shadowCache.object( key ) )
+				{
+					return *shadow;
+				}
+			}
+
+			QImage shadow = createShadowImage( image, color );
+
+			QMutexLocker locker( &shadowCacheMutex );
+			shadowCache.insert( key, new QImage( shadow ), shadow.byteCount() / 1024 + 1 );
+
+			return shadow;
+		}
+
+
+		///
+		/// Create shadow image
+		///
+		QImage ModelImageObject::createShadowImage( const QImage& image,
+		                                            const QColor& color ) const
+		{
+			QImage source = image.convertToFormat( QImage::Format_ARGB32 );
+
+			QImage shadow( source.size(), QImage::Format_ARGB32 );
+			for ( int iy = 0; iy < shadow.height(); iy++ )
+			{
+				tintScanLine( reinterpret_cast<const QRgb*>( source.constScanLine( iy ) ),
+				              reinterpret_cast<QRgb*>( shadow.scanLine( iy ) ),
+				              shadow.width(),
+				              color.rgb() & RGB_MASK,
+				              color.alpha() );
+			}
+
 			return shadow;
 		}
 
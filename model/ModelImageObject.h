@@ -114,6 +114,12 @@ namespace glabels
 			void setImage( const QImage& value ) override;
 			void setImage( const QString& name, const QImage& value ) override;
 
+			//
+			// Image Property: imageData (encoded PNG source of image, if known)
+			//
+			QByteArray imageData() const;
+			void setImageData( const QByteArray& value );
+
 			//
 			// Image Property: svg
 			//
@@ -134,6 +140,10 @@ namespace glabels
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
+		public:
+			QString contentKey( merge::Record* record,
+			                    Variables*     variables ) const override;
+
 		protected:
 			void drawShadow( QPainter*      painter,
 			                 bool           inEditor,
@@ -156,10 +166,21 @@ namespace glabels
 			bool readImageFile( const QString& fileName,
 			                    QImage*&       image,
 			                    QSvgRenderer*& svgRenderer,
-			                    QByteArray&    svg ) const;
+			                    QByteArray&    svg,
+			                    QByteArray&    imageData ) const;
+
+			QString findImageFile( const QString& fileName ) const;
+
+			bool readCachedImageFile( const QString& fileName,
+			                          const QSize&   deviceSize,
+			                          QImage&        image,
+			                          QByteArray&    svg ) const;
+
+			QImage shadowImage( const QImage& image,
+			                    const QColor& color ) const;
 
-			QImage* createShadowImage( const QImage& image,
-			                           const QColor& color ) const;
+			QImage createShadowImage( const QImage& image,
+			                          const QColor& color ) const;
 	
 
 			///////////////////////////////////////////////////////////////
@@ -170,6 +191,8 @@ namespace glabels
 			QImage*        mImage;
 			QSvgRenderer*  mSvgRenderer;
 			QByteArray     mSvg;
+			QByteArray     mImageData;
+			qint64         mImageDataKey;
 
 			static QImage* smDefaultImage;
 
@@ -183,6 +183,17 @@ namespace glabels
 		}
 
 
+		///
+		/// Content key
+		///
+		QString ModelLineObject::contentKey( merge::Record* record,
+		                                     Variables*     variables ) const
+		{
+			return ModelObject::contentKey( record, variables )
+			       + QChar(0x1F) + QString::number( mLineColorNode.color( record, variables ).rgba(), 16 );
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -96,6 +96,10 @@ namespace glabels
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
+		public:
+			QString contentKey( merge::Record* record,
+			                    Variables*     variables ) const override;
+
 		protected:
 			void drawShadow( QPainter*      painter,
 			                 bool           inEditor,
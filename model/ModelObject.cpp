@@ -63,6 +63,12 @@ namespace glabels
 			mSelectedFlag = false;
 
 			mOutline = nullptr;
+
+			mInverseMatrixValid = false;
+			mHoverPathValid     = false;
+			mHoverPathScale     = 0;
+
+			connect( this, SIGNAL(changed()), this, SLOT(onChanged()) );
 		}
 
 
@@ -99,6 +105,12 @@ namespace glabels
 			mSelectedFlag = false;
 
 			mOutline = nullptr;
+
+			mInverseMatrixValid = false;
+			mHoverPathValid     = false;
+			mHoverPathScale     = 0;
+
+			connect( this, SIGNAL(changed()), this, SLOT(onChanged()) );
 		}
 	
 		
@@ -138,6 +150,12 @@ namespace glabels
 			}
 
 			mMatrix          = object->mMatrix;
+
+			mInverseMatrixValid = false;
+			mHoverPathValid     = false;
+			mHoverPathScale     = 0;
+
+			connect( this, SIGNAL(changed()), this, SLOT(onChanged()) );
 		}
 
 
@@ -1179,9 +1197,9 @@ namespace glabels
 			 * Change point to object relative coordinates
 			 */
 			p -= QPointF( mX0.pt(), mY0.pt() ); // Translate point to x0,y0
-			p = mMatrix.inverted().map( p );
+			p = inverseMatrix().map( p );
 
-			if ( hoverPath( scale ).contains( p ) )
+			if ( cachedHoverPath( scale ).contains( p ) )
 			{
 				return true;
 			}
@@ -1208,11 +1226,11 @@ namespace glabels
 			{
 				QPointF p( x.pt(), y.pt() );
 				p -= QPointF( mX0.pt(), mY0.pt() ); // Translate point to x0,y0
+				p = inverseMatrix().map( p );
 
 				foreach ( Handle* handle, mHandles )
 				{
-					QPainterPath handlePath = mMatrix.map( handle->path( scale ) );
-					if ( handlePath.contains( p ) )
+					if ( handle->path( scale ).contains( p ) )
 					{
 						return handle;
 					}
@@ -1223,6 +1241,68 @@ namespace glabels
 		}
 
 
+		///
+		/// Bounding rect of all points where isLocatedAt() may be true
+		///
+		/// Covers the extent of the object, its hover path and its outline, so that
+		/// it also bounds the object when selected.  Handles are not included.
+		///
+		QRectF ModelObject::hoverRect( double scale ) const
+		{
+			QRectF rect( (-lineWidth()/2).pt(), (-lineWidth()/2).pt(),
+			             (mW + lineWidth()).pt(), (mH + lineWidth()).pt() );
+
+			rect = rect.normalized().united( cachedHoverPath( scale ).boundingRect() );
+			if ( mOutline )
+			{
+				rect = rect.united( mOutline->hoverPath( scale ).boundingRect() );
+			}
+
+			return mMatrix.mapRect( rect ).translated( mX0.pt(), mY0.pt() );
+		}
+
+
+		///
+		/// Inverse of matrix, cached until changed
+		///
+		const QMatrix& ModelObject::inverseMatrix() const
+		{
+			if ( !mInverseMatrixValid )
+			{
+				mInverseMatrix      = mMatrix.inverted();
+				mInverseMatrixValid = true;
+			}
+
+			return mInverseMatrix;
+		}
+
+
+		///
+		/// Hover path, cached until changed or scale changes
+		///
+		const QPainterPath& ModelObject::cachedHoverPath( double scale ) const
+		{
+			if ( !mHoverPathValid || (mHoverPathScale != scale) )
+			{
+				mHoverPath      = hoverPath( scale );
+				mHoverPathScale = scale;
+				mHoverPathValid = true;
+			}
+
+			return mHoverPath;
+		}
+
+
+		///
+		/// Changed handler: drop cached matrix inverse and hover path
+		///
+		void ModelObject::onChanged()
+		{
+			mInverseMatrixValid = false;
+			mHoverPathValid     = false;
+		}
+
+
 		///
 		/// Draw object + shadow
 		///
@@ -1250,6 +1330,27 @@ namespace glabels
 		}
 
 
+		///
+		/// Content key
+		///
+		/// Identifies everything drawn by the object that can vary from one
+		/// label to the next, i.e. anything expanded from the merge record or
+		/// variables.  Identical keys imply identical drawings.
+		///
+		QString ModelObject::contentKey( merge::Record* record,
+		                                 Variables*     variables ) const
+		{
+			QString key;
+
+			if ( mShadowState )
+			{
+				key += QString::number( mShadowColorNode.color( record, variables ).rgba(), 16 );
+			}
+
+			return key;
+		}
+
+
 		///
 		/// Draw selection highlights
 		///
@@ -406,6 +406,7 @@ namespace glabels
 			void flipVert();
 			bool isLocatedAt( double scale, const Distance& x, const Distance& y ) const;
 			Handle* handleAt( double scale, const Distance& x, const Distance& y ) const;
+			QRectF hoverRect( double scale ) const;
 
 
 			///////////////////////////////////////////////////////////////
@@ -419,6 +420,9 @@ namespace glabels
 			
 			void drawSelectionHighlight( QPainter* painter, double scale ) const;
 
+			virtual QString contentKey( merge::Record* record,
+			                            Variables*     variables ) const;
+
 		protected:
 			virtual void drawShadow( QPainter*      painter,
 			                         bool           inEditor,
@@ -434,6 +438,13 @@ namespace glabels
 
 			virtual void sizeUpdated();
 
+		private:
+			const QMatrix& inverseMatrix() const;
+			const QPainterPath& cachedHoverPath( double scale ) const;
+
+		private slots:
+			void onChanged();
+
 		
 			///////////////////////////////////////////////////////////////
 			// Protected Members
@@ -466,6 +477,12 @@ namespace glabels
 
 			QMatrix    mMatrix;
 
+			mutable bool         mInverseMatrixValid;
+			mutable QMatrix      mInverseMatrix;
+			mutable bool         mHoverPathValid;
+			mutable double       mHoverPathScale;
+			mutable QPainterPath mHoverPath;
+
 		};
 
 	}
@@ -207,5 +207,17 @@ namespace glabels
 			return true;
 		}
 
+
+		///
+		/// Content key
+		///
+		QString ModelShapeObject::contentKey( merge::Record* record,
+		                                      Variables*     variables ) const
+		{
+			return ModelObject::contentKey( record, variables )
+			       + QChar(0x1F) + QString::number( mLineColorNode.color( record, variables ).rgba(), 16 )
+			       + QChar(0x1F) + QString::number( mFillColorNode.color( record, variables ).rgba(), 16 );
+		}
+
 	}
 }
@@ -97,6 +97,14 @@ namespace glabels
 			bool canLineWidth() const override;
 
 
+			///////////////////////////////////////////////////////////////
+			// Drawing operations
+			///////////////////////////////////////////////////////////////
+		public:
+			QString contentKey( merge::Record* record,
+			                    Variables*     variables ) const override;
+
+
 			///////////////////////////////////////////////////////////////
 			// Private Members
 			///////////////////////////////////////////////////////////////
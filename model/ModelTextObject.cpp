@@ -23,9 +23,13 @@
 #include "Size.h"
 
 #include <QBrush>
+#include <QCache>
+#include <QCoreApplication>
 #include <QPen>
 #include <QTextDocument>
 #include <QTextBlock>
+#include <QThread>
+#include <QThreadStorage>
 #include <QRegularExpression>
 #include <QtDebug>
 
@@ -41,6 +45,72 @@ namespace glabels
 		namespace
 		{
 			const double marginPts = 3;
+
+			const int maxCachedLayouts = 256;
+			const int maxCachedFontSizes = 1024;
+
+
+			///
+			/// Text laid out at origin, ready to draw without reshaping
+			///
+			struct TextLayout
+			{
+				QList<QTextLayout*> layouts;
+				double              height;
+
+				~TextLayout()
+				{
+					qDeleteAll( layouts );
+				}
+			};
+
+
+			///
+			/// Layout cache, shared by all text objects of a thread
+			///
+			/// Per thread, because shaped layouts hold font engines, which may not be
+			/// used from other threads.
+			///
+			QThreadStorage<QCache<QString,TextLayout>*> layoutCaches;
+
+			void clearLayoutCache()
+			{
+				// Font engines must be released before fonts are torn down at exit
+				if ( layoutCaches.hasLocalData() )
+				{
+					layoutCaches.localData()->clear();
+				}
+			}
+
+			QCache<QString,TextLayout>* layoutCache()
+			{
+				if ( !layoutCaches.hasLocalData() )
+				{
+					layoutCaches.setLocalData( new QCache<QString,TextLayout>( maxCachedLayouts ) );
+
+					QCoreApplication* app = QCoreApplication::instance();
+					if ( app && (QThread::currentThread() == app->thread()) )
+					{
+						qAddPostRoutine( clearLayoutCache );
+					}
+				}
+				return layoutCaches.localData();
+			}
+
+
+			///
+			/// Auto shrink font size cache, per thread like the layout cache
+			///
+			QThreadStorage<QCache<QString,double>*> fontSizeCaches;
+
+			QCache<QString,double>* fontSizeCache()
+			{
+				if ( !fontSizeCaches.hasLocalData() )
+				{
+					fontSizeCaches.setLocalData( new QCache<QString,double>( maxCachedFontSizes ) );
+				}
+				return fontSizeCaches.localData();
+			}
 		}
 
 
@@ -514,6 +584,18 @@ namespace glabels
 		}
 
 
+		///
+		/// Content key
+		///
+		QString ModelTextObject::contentKey( merge::Record* record,
+		                                     Variables*     variables ) const
+		{
+			return ModelObject::contentKey( record, variables )
+			       + QChar(0x1F) + QString::number( mTextColorNode.color( record, variables ).rgba(), 16 )
+			       + QChar(0x1F) + mText.expand( record, variables );
+		}
+
+
 		///
 		/// Draw shadow of object
 		///
@@ -671,7 +753,7 @@ namespace glabels
 		{
 			painter->save();
 
-			painter->setClipRect( QRectF( 0, 0, mW.pt(), mH.pt() ) );
+			painter->setClipRect( QRectF( 0, 0, mW.pt(), mH.pt() ), Qt::IntersectClip );
 			
 			if ( mText.isEmpty() )
 			{
@@ -704,11 +786,75 @@ namespace glabels
 		{
 			painter->save();
 
-			painter->setClipRect( QRectF( 0, 0, mW.pt(), mH.pt() ) );
-			
+			painter->setClipRect( QRectF( 0, 0, mW.pt(), mH.pt() ), Qt::IntersectClip );
+
+			QString text     = mText.expand( record, variables );
+			double  fontSize = mTextAutoShrink ? autoShrinkFontSize( text ) : mFontSize;
+
+			// Look for layout of identical text, e.g. fixed text or repeated merge values
+			QString key = text
+				+ QChar(0x1F) + mFontFamily
+				+ QChar(0x1F) + QString::number( fontSize, 'g', 12 )
+				+ QChar(0x1F) + QString::number( mFontWeight )
+				+ QChar(0x1F) + QString::number( mFontItalicFlag )
+				+ QChar(0x1F) + QString::number( mFontUnderlineFlag )
+				+ QChar(0x1F) + QString::number( mTextHAlign )
+				+ QChar(0x1F) + QString::number( mTextWrapMode )
+				+ QChar(0x1F) + QString::number( mW.pt(), 'g', 12 )
+				+ QChar(0x1F) + QString::number( mTextLineSpacing, 'g', 12 );
+
+			TextLayout* layout = layoutCache()->object( key );
+			if ( !layout )
+			{
+				layout = new TextLayout;
+				layoutText( text, fontSize, layout->layouts, layout->height );
+				layoutCache()->insert( key, layout );
+			}
+
+			// Adjust for vertical alignment
+			double y;
+			switch ( mTextVAlign )
+			{
+			case Qt::AlignVCenter:
+				y = mH.pt()/2 - layout->height/2;
+				break;
+			case Qt::AlignBottom:
+				y = mH.pt() - layout->height - marginPts;
+				break;
+			default:
+				y = marginPts;
+				break;
+			}
+
+			painter->setPen( QPen( color ) );
+			painter->translate( marginPts, y );
+
+			// Layouts keep their shaping, and are drawn as real text on every device,
+			// including QPictures that are later replayed into a PDF
+			foreach ( const QTextLayout* textLayout, layout->layouts )
+			{
+				textLayout->draw( painter, QPointF( 0, 0 ) );
+			}
+
+			painter->restore();
+		}
+
+
+		///
+		/// Lay out text at origin, one text layout per paragraph
+		///
+		/// The caller owns the returned layouts, which cache their shaping for
+		/// repeated drawing.
+		///
+		void
+		ModelTextObject::layoutText( const QString&        text,
+		                             double                fontSize,
+		                             QList<QTextLayout*>&  layouts,
+		                             double&               height ) const
+		{
 			QFont font;
 			font.setFamily( mFontFamily );
-			font.setPointSizeF( mTextAutoShrink ? autoShrinkFontSize( record, variables ) : mFontSize );
+			font.setPointSizeF( fontSize );
 			font.setWeight( mFontWeight );
 			font.setItalic( mFontItalicFlag );
 			font.setUnderline( mFontUnderlineFlag );
@@ -720,84 +866,106 @@ namespace glabels
 			QFontMetricsF fontMetrics( font );
 			double dy = fontMetrics.lineSpacing() * mTextLineSpacing;
 
-			QTextDocument document( mText.expand( record, variables ) );
-
-			QList<QTextLayout*> layouts;
+			QTextDocument document( text );
 
-			// Pass #1 -- do initial layouts
-			double x = 0;
 			double y = 0;
 			QRectF boundingRect;
 			for ( int i = 0; i < document.blockCount(); i++ )
 			{
-				QTextLayout* layout = new QTextLayout( document.findBlockByNumber(i).text() );
+				auto* layout = new QTextLayout( document.findBlockByNumber(i).text() );
 		
+				layout->setCacheEnabled( true );
 				layout->setFont( font );
 				layout->setTextOption( textOption );
-				layout->setCacheEnabled(true);
 
 				layout->beginLayout();
 				for ( QTextLine l = layout->createLine(); l.isValid(); l = layout->createLine() )
 				{
 					l.setLineWidth( mW.pt() - 2*marginPts );
-					l.setPosition( QPointF( x, y ) );
+					l.setPosition( QPointF( 0, y ) );
 					y += dy;
 				}
 				layout->endLayout();
 
-				layouts.append( layout );
+				layouts << layout;
 
 				boundingRect = layout->boundingRect().united( boundingRect );
 			}
-			double h = boundingRect.height();
 
+			height = boundingRect.height();
+		}
 
-			// Pass #2 -- adjust layout positions for vertical alignment
-			x = marginPts;
-			switch ( mTextVAlign )
+
+		///
+		/// Determine auto shrink font size
+		///
+		/// Largest of mFontSize, mFontSize-0.5, mFontSize-1, ... (down to 1) at which
+		/// text fits.  Fit is monotonic in font size, so candidates are bisected.
+		///
+		double
+		ModelTextObject::autoShrinkFontSize( const QString& text ) const
+		{
+			// Look for earlier result for identical text and box, e.g. repeated merge values
+			QString key = text
+				+ QChar(0x1F) + mFontFamily
+				+ QChar(0x1F) + QString::number( mFontSize, 'g', 12 )
+				+ QChar(0x1F) + QString::number( mFontWeight )
+				+ QChar(0x1F) + QString::number( mFontItalicFlag )
+				+ QChar(0x1F) + QString::number( mFontUnderlineFlag )
+				+ QChar(0x1F) + QString::number( mTextHAlign )
+				+ QChar(0x1F) + QString::number( mTextWrapMode )
+				+ QChar(0x1F) + QString::number( mW.pt(), 'g', 12 )
+				+ QChar(0x1F) + QString::number( mH.pt(), 'g', 12 )
+				+ QChar(0x1F) + QString::number( mTextLineSpacing, 'g', 12 );
+
+			if ( double* size = fontSizeCache()->object( key ) )
 			{
-			case Qt::AlignVCenter:
-				y = mH.pt()/2 - h/2;
-				break;
-			case Qt::AlignBottom:
-				y = mH.pt() - h - marginPts;
-				break;
-			default:
-				y = marginPts;
-				break;
+				return *size;
 			}
-			foreach ( QTextLayout* layout, layouts )
+
+			// Candidate i is mFontSize - 0.5*i; nCandidates is the 1st one not above 1 pt,
+			// which is used without testing
+			int nCandidates = 0;
+			for ( double candidateSize = mFontSize; candidateSize > 1.0; candidateSize -= 0.5 )
 			{
-				for ( int j = 0; j < layout->lineCount(); j++ )
-				{
-					QTextLine l = layout->lineAt(j);
-					l.setPosition( QPointF( x, y ) );
-					y += dy;
-				}
+				nCandidates++;
 			}
 
-			// Draw layouts
-			painter->setPen( QPen( color ) );
-			foreach ( QTextLayout* layout, layouts )
+			int lo = 0;
+			int hi = nCandidates;
+			if ( (nCandidates > 0) && textFits( text, mFontSize ) )
 			{
-				layout->draw( painter, QPointF( 0, 0 ) );
+				hi = 0; // Common case
+			}
+			while ( lo < hi )
+			{
+				int mid = (lo + hi) / 2;
+				if ( textFits( text, mFontSize - 0.5*mid ) )
+				{
+					hi = mid;
+				}
+				else
+				{
+					lo = mid + 1;
+				}
 			}
 
-			// Cleanup
-			qDeleteAll( layouts );
+			double size = mFontSize - 0.5*lo;
+			fontSizeCache()->insert( key, new double( size ) );
 
-			painter->restore();
+			return size;
 		}
 
 
 		///
-		/// Determine auto shrink font size
+		/// Does text fit in object's bounding box at given font size?
 		///
-		double
-		ModelTextObject::autoShrinkFontSize( merge::Record* record, Variables* variables ) const
+		bool
+		ModelTextObject::textFits( const QString& text, double fontSize ) const
 		{
 			QFont font;
 			font.setFamily( mFontFamily );
+			font.setPointSizeF( fontSize );
 			font.setWeight( mFontWeight );
 			font.setItalic( mFontItalicFlag );
 			font.setUnderline( mFontUnderlineFlag );
@@ -806,53 +974,37 @@ namespace glabels
 			textOption.setAlignment( mTextHAlign );
 			textOption.setWrapMode( mTextWrapMode );
 
-			QTextDocument document( mText.expand( record, variables ) );
-
-			double candidateSize = mFontSize;
-			while ( candidateSize > 1.0 )
-			{
-				font.setPointSizeF( candidateSize );
+			QTextDocument document( text );
 
-				// Line spacing is affected by font size
-				QFontMetricsF fontMetrics( font );
-				double dy = fontMetrics.lineSpacing() * mTextLineSpacing;
+			// Line spacing is affected by font size
+			QFontMetricsF fontMetrics( font );
+			double dy = fontMetrics.lineSpacing() * mTextLineSpacing;
 
-				// Do candidate layouts, letting text flow according to wrap mode
-				double x = 0;
-				double y = 0;
-				QRectF layoutsRect;
-				for ( int i = 0; i < document.blockCount(); i++ )
-				{
-					QTextLayout layout( document.findBlockByNumber(i).text() );
+			// Do candidate layouts, letting text flow according to wrap mode
+			double x = 0;
+			double y = 0;
+			QRectF layoutsRect;
+			for ( int i = 0; i < document.blockCount(); i++ )
+			{
+				QTextLayout layout( document.findBlockByNumber(i).text() );
 		
-					layout.setFont( font );
-					layout.setTextOption( textOption );
-					layout.setCacheEnabled(true);
+				layout.setFont( font );
+				layout.setTextOption( textOption );
 
-					layout.beginLayout();
-					for ( QTextLine l = layout.createLine(); l.isValid(); l = layout.createLine() )
-					{
-						l.setLineWidth( mW.pt() - 2*marginPts );
-						l.setPosition( QPointF( x, y ) );
-						y += dy;
-					}
-					layout.endLayout();
-
-					layoutsRect = layout.boundingRect().united( layoutsRect );
-				}
-
-				// Did this candidate fit in our object's bounding box?
-				if ( ( (layoutsRect.width() + 2*marginPts) <= mW.pt() ) &&
-				     ( (layoutsRect.height() + 2*marginPts) <= mH.pt() ) )
+				layout.beginLayout();
+				for ( QTextLine l = layout.createLine(); l.isValid(); l = layout.createLine() )
 				{
-					break;
+					l.setLineWidth( mW.pt() - 2*marginPts );
+					l.setPosition( QPointF( x, y ) );
+					y += dy;
 				}
+				layout.endLayout();
 
-				// If not, let's try a slightly smaller font size
-				candidateSize -= 0.5;
+				layoutsRect = layout.boundingRect().united( layoutsRect );
 			}
 
-			return candidateSize;
+			return ( (layoutsRect.width() + 2*marginPts) <= mW.pt() ) &&
+			       ( (layoutsRect.height() + 2*marginPts) <= mH.pt() );
 		}
 
 
@@ -25,6 +25,7 @@
 #include "ModelObject.h"
 #include "RawText.h"
 
+#include <QList>
 #include <QTextLayout>
 
 
@@ -185,6 +186,10 @@ namespace glabels
 			///////////////////////////////////////////////////////////////
 			// Drawing operations
 			///////////////////////////////////////////////////////////////
+		public:
+			QString contentKey( merge::Record* record,
+			                    Variables*     variables ) const override;
+
 		protected:
 			void drawShadow( QPainter*      painter,
 			                 bool           inEditor,
@@ -213,9 +218,16 @@ namespace glabels
 			               const QColor&  color,
 			               merge::Record* record,
 			               Variables*     variables ) const;
+
+			void layoutText( const QString&        text,
+			                 double                fontSize,
+			                 QList<QTextLayout*>&  layouts,
+			                 double&               height ) const;
 			
-			double autoShrinkFontSize( merge::Record* record,
-			                           Variables*     variables ) const;
+			double autoShrinkFontSize( const QString& text ) const;
+
+			bool textFits( const QString& text,
+			               double         fontSize ) const;
 	
 
 			///////////////////////////////////////////////////////////////
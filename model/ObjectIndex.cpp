@@ -0,0 +1,223 @@
+/*  ObjectIndex.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ObjectIndex.h"
+
+#include "ModelObject.h"
+
+#include <cmath>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		//
+		// Private
+		//
+		namespace
+		{
+			const int maxCellsPerSide = 64;
+		}
+
+
+		///
+		/// Constructor
+		///
+		ObjectIndex::ObjectIndex()
+			: mValid(false), mScale(1), mCellSize(1), mNx(0), mNy(0)
+		{
+			// empty
+		}
+
+
+		///
+		/// Invalidate index
+		///
+		void ObjectIndex::clear()
+		{
+			mValid = false;
+			mObjects.clear();
+			mRects.clear();
+			mBounds = QRectF();
+			mNx = 0;
+			mNy = 0;
+			mCells.clear();
+		}
+
+
+		///
+		/// Is index valid for scale?
+		///
+		bool ObjectIndex::isValid( double scale ) const
+		{
+			return mValid && (mScale == scale);
+		}
+
+
+		///
+		/// Scale of last build
+		///
+		double ObjectIndex::scale() const
+		{
+			return mScale;
+		}
+
+
+		///
+		/// Build index of objects at scale
+		///
+		/// Cells are sized so that there is about one object per cell.
+		///
+		void ObjectIndex::build( const QList<ModelObject*>& objects, double scale )
+		{
+			clear();
+
+			mValid   = true;
+			mScale   = scale;
+			mObjects = objects;
+
+			foreach ( ModelObject* object, mObjects )
+			{
+				QRectF rect = object->hoverRect( scale );
+				mRects << rect;
+				mBounds = mBounds.isNull() ? rect : mBounds.united( rect );
+			}
+
+			if ( mObjects.isEmpty() )
+			{
+				return;
+			}
+
+			double n = std::ceil( std::sqrt( double( mObjects.size() ) ) );
+			mCellSize = qMax( qMax( mBounds.width(), mBounds.height() ) / qMin( n, double(maxCellsPerSide) ), 1.0 );
+			mNx = cellX( mBounds.right() ) + 1;
+			mNy = cellY( mBounds.bottom() ) + 1;
+			mCells.resize( mNx*mNy );
+
+			for ( int i = 0; i < mRects.size(); i++ )
+			{
+				int ix1 = cellX( mRects[i].left() );
+				int ix2 = cellX( mRects[i].right() );
+				int iy1 = cellY( mRects[i].top() );
+				int iy2 = cellY( mRects[i].bottom() );
+
+				for ( int iy = iy1; iy <= iy2; iy++ )
+				{
+					for ( int ix = ix1; ix <= ix2; ix++ )
+					{
+						mCells[iy*mNx + ix] << i;
+					}
+				}
+			}
+		}
+
+
+		///
+		/// Objects whose hover rect contains p, bottom to top
+		///
+		QList<ModelObject*> ObjectIndex::objectsAt( const QPointF& p ) const
+		{
+			QList<ModelObject*> list;
+
+			if ( mObjects.isEmpty() ||
+			     (p.x() < mBounds.left()) || (p.x() > mBounds.right()) ||
+			     (p.y() < mBounds.top()) || (p.y() > mBounds.bottom()) )
+			{
+				return list;
+			}
+
+			// Cell lists are in object order
+			foreach ( int i, mCells[cellY( p.y() )*mNx + cellX( p.x() )] )
+			{
+				const QRectF& r = mRects[i];
+				if ( (p.x() >= r.left()) && (p.x() <= r.right()) && (p.y() >= r.top()) && (p.y() <= r.bottom()) )
+				{
+					list << mObjects[i];
+				}
+			}
+
+			return list;
+		}
+
+
+		///
+		/// Objects whose hover rect intersects rect, bottom to top
+		///
+		QList<ModelObject*> ObjectIndex::objectsIn( const QRectF& rect ) const
+		{
+			QList<ModelObject*> list;
+
+			if ( mObjects.isEmpty() ||
+			     (rect.right() < mBounds.left()) || (rect.left() > mBounds.right()) ||
+			     (rect.bottom() < mBounds.top()) || (rect.top() > mBounds.bottom()) )
+			{
+				return list;
+			}
+
+			QVector<bool> found( mObjects.size(), false );
+
+			for ( int iy = cellY( rect.top() ); iy <= cellY( rect.bottom() ); iy++ )
+			{
+				for ( int ix = cellX( rect.left() ); ix <= cellX( rect.right() ); ix++ )
+				{
+					foreach ( int i, mCells[iy*mNx + ix] )
+					{
+						found[i] = true;
+					}
+				}
+			}
+
+			for ( int i = 0; i < found.size(); i++ )
+			{
+				if ( found[i] &&
+				     (mRects[i].right() >= rect.left()) && (mRects[i].left() <= rect.right()) &&
+				     (mRects[i].bottom() >= rect.top()) && (mRects[i].top() <= rect.bottom()) )
+				{
+					list << mObjects[i];
+				}
+			}
+
+			return list;
+		}
+
+
+		///
+		/// Column of x, clamped to grid
+		///
+		int ObjectIndex::cellX( double x ) const
+		{
+			int ix = int( (x - mBounds.left()) / mCellSize );
+			return (mNx > 0) ? qBound( 0, ix, mNx-1 ) : ix;
+		}
+
+
+		///
+		/// Row of y, clamped to grid
+		///
+		int ObjectIndex::cellY( double y ) const
+		{
+			int iy = int( (y - mBounds.top()) / mCellSize );
+			return (mNy > 0) ? qBound( 0, iy, mNy-1 ) : iy;
+		}
+
+	}
+}
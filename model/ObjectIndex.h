@@ -0,0 +1,98 @@
+/*  ObjectIndex.h
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef model_ObjectIndex_h
+#define model_ObjectIndex_h
+
+
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+
+namespace glabels
+{
+	namespace model
+	{
+
+		// Forward references
+		class ModelObject;
+
+
+		///
+		/// Object Index
+		///
+		/// Uniform grid over the hover rects of a list of objects, used to find
+		/// candidates for hit-testing without visiting every object.  Candidates
+		/// are returned in list order, i.e. from bottom to top.
+		///
+		class ObjectIndex
+		{
+			/////////////////////////////////
+			// Life Cycle
+			/////////////////////////////////
+		public:
+			ObjectIndex();
+
+
+			/////////////////////////////////
+			// Public Methods
+			/////////////////////////////////
+		public:
+			void clear();
+			bool isValid( double scale ) const;
+			double scale() const;
+			void build( const QList<ModelObject*>& objects, double scale );
+
+			QList<ModelObject*> objectsAt( const QPointF& p ) const;
+			QList<ModelObject*> objectsIn( const QRectF& rect ) const;
+
+
+			/////////////////////////////////
+			// Internal Methods
+			/////////////////////////////////
+		private:
+			int cellX( double x ) const;
+			int cellY( double y ) const;
+
+
+			/////////////////////////////////
+			// Private Data
+			/////////////////////////////////
+		private:
+			bool                 mValid;
+			double               mScale;
+
+			QList<ModelObject*>  mObjects;
+			QVector<QRectF>      mRects;
+
+			QRectF               mBounds;
+			double               mCellSize;
+			int                  mNx;
+			int                  mNy;
+			QVector<QVector<int>> mCells;
+		};
+
+	}
+}
+
+
+#endif // model_ObjectIndex_h
@@ -26,6 +26,9 @@
 #include "merge/None.h"
 #include "merge/Record.h"
 
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
 #include <QtDebug>
 
 
@@ -43,13 +46,83 @@ namespace glabels
 			const double labelOutlineWidth = 0.25;
 			const double tickOffset = 2.25;
 			const double tickLength = 18;
+
+			const int maxLabelCacheCost = 64 * 1024; // KiB, pictures hold full copies of their images
+
+
+			///
+			/// Pages rendered by workers, waiting to be written in order
+			///
+			struct PageQueue
+			{
+				QMutex             mutex;
+				QWaitCondition     pageReady;
+				QWaitCondition     pageTaken;
+				QMap<int,QPicture> pages;
+				int                iNextPage;
+				int                window;
+			};
+
+
+			///
+			/// Worker thread rendering every nJobs'th page into a QPicture
+			///
+			class PageWorker : public QThread
+			{
+			public:
+				PageWorker( PageRenderer* renderer, int iFirstPage, int nJobs, int nPages, PageQueue* queue )
+					: mRenderer(renderer), mIFirstPage(iFirstPage), mNJobs(nJobs), mNPages(nPages), mQueue(queue)
+				{
+				}
+
+				~PageWorker() override
+				{
+					auto* model = mRenderer->model();
+					delete mRenderer;
+					delete model->variables();
+					delete model;
+				}
+
+			protected:
+				void run() override
+				{
+					for ( int iPage = mIFirstPage; iPage < mNPages; iPage += mNJobs )
+					{
+						// Do not get too far ahead of the writer
+						mQueue->mutex.lock();
+						while ( (iPage - mQueue->iNextPage) >= mQueue->window )
+						{
+							mQueue->pageTaken.wait( &mQueue->mutex );
+						}
+						mQueue->mutex.unlock();
+
+						QPicture picture;
+						QPainter painter( &picture );
+						mRenderer->printPage( &painter, iPage );
+						painter.end();
+
+						mQueue->mutex.lock();
+						mQueue->pages.insert( iPage, picture );
+						mQueue->pageReady.wakeAll();
+						mQueue->mutex.unlock();
+					}
+				}
+
+			private:
+				PageRenderer* mRenderer;
+				int           mIFirstPage;
+				int           mNJobs;
+				int           mNPages;
+				PageQueue*    mQueue;
+			};
+
 		}
 
 
 		PageRenderer::PageRenderer( const Model* model )
 			: mModel(nullptr), mMerge(nullptr), mVariables(nullptr), mNCopies(0), mStartLabel(0), mLastLabel(0),
-			  mPrintOutlines(false), mPrintCropMarks(false), mPrintReverse(false),
-			  mIPage(0), mIsMerge(false), mNPages(0), mNLabelsPerPage(0)
+			  mPrintOutlines(false), mPrintCropMarks(false), mPrintReverse(false), mLabelCache(false),
+			  mIPage(0), mAbortFlag(nullptr), mIsMerge(false), mNPages(0), mNLabelsPerPage(0), mLabelPictures(maxLabelCacheCost)
 		{
 			if ( model )
 			{
@@ -82,6 +155,7 @@ namespace glabels
 			mNLabelsPerPage = mModel->frame()->nLabels();
 			mIsMerge = ( dynamic_cast<const merge::None*>(mMerge) == nullptr );
 			updateNPages();
+			mLabelPictures.clear();
 
 			emit changed();
 		}
@@ -129,6 +203,20 @@ namespace glabels
 		}
 
 	
+		///
+		/// Enable label cache
+		///
+		/// When enabled, each distinct label (as identified by Model::contentKey())
+		/// is drawn only once into a QPicture, which is replayed for later labels
+		/// with identical content.
+		///
+		void PageRenderer::setLabelCache( bool labelCacheFlag )
+		{
+			mLabelCache = labelCacheFlag;
+			mLabelPictures.clear();
+		}
+
+	
 		void PageRenderer::setIPage( int iPage )
 		{
 			mIPage = iPage;
@@ -137,6 +225,18 @@ namespace glabels
 		}
 
 	
+		///
+		/// Set abort flag
+		///
+		/// While the flag is set, printing stops before the next label.  Used to
+		/// cancel rendering from another thread.
+		///
+		void PageRenderer::setAbortFlag( const QAtomicInt* abortFlag )
+		{
+			mAbortFlag = abortFlag;
+		}
+
+	
 		int PageRenderer::nItems() const
 		{
 			return mLastLabel - mStartLabel;
@@ -185,6 +285,20 @@ namespace glabels
 			{
 				mNPages = 0;
 			}
+
+			clearCheckpoints();
+		}
+
+
+		///
+		/// Forget saved page checkpoints
+		///
+		/// Any change to the model, its variables, its merge source or selection,
+		/// the number of copies, or the start label invalidates the saved state.
+		///
+		void PageRenderer::clearCheckpoints()
+		{
+			mCheckpoints.clear();
 		}
 
 	
@@ -193,27 +307,129 @@ namespace glabels
 		///
 		void PageRenderer::print( QPrinter* printer ) const
 		{
-			QSizeF pageSize( mModel->tmplate()->pageWidth().pt(), mModel->tmplate()->pageHeight().pt() );
-			printer->setPageSize( QPageSize(pageSize, QPageSize::Point) );
-			printer->setFullPage( true );
-			printer->setPageMargins( 0, 0, 0, 0, QPrinter::Point );
+			setupPrinter( printer );
 
 			QPainter painter( printer );
-			
-			QRectF rectPx  = printer->paperRect( QPrinter::DevicePixel );
-			QRectF rectPts = printer->paperRect( QPrinter::Point );
-			painter.scale( rectPx.width()/rectPts.width(), rectPx.height()/rectPts.height() );
+			scaleToPoints( printer, &painter );
 
+			// Single pass over all labels, emitting each page as it is completed
+			printPages( &painter, printer, 0, mNPages );
+		}
+
+
+		///
+		/// Print using multiple worker threads
+		///
+		/// Each worker renders every nJobs'th page from its own copy of the model
+		/// and variables into a QPicture.  Pictures are replayed onto the printer
+		/// in page order as they become available.
+		///
+		void PageRenderer::print( QPrinter* printer, int nJobs ) const
+		{
+			nJobs = qMin( nJobs, mNPages );
+			if ( nJobs <= 1 )
+			{
+				print( printer );
+				return;
+			}
+
+			setupPrinter( printer );
+
+			QPainter painter( printer );
+			scaleToPoints( printer, &painter );
+
+			PageQueue queue;
+			queue.iNextPage = 0;
+			queue.window    = 2*nJobs;
+
+			QList<PageWorker*> workers;
+			for ( int iJob = 0; iJob < nJobs; iJob++ )
+			{
+				workers << new PageWorker( cloneForWorker(), iJob, nJobs, mNPages, &queue );
+			}
+			foreach ( PageWorker* worker, workers )
+			{
+				worker->start();
+			}
 
 			for ( int iPage = 0; iPage < mNPages; iPage++ )
 			{
+				queue.mutex.lock();
+				while ( !queue.pages.contains( iPage ) )
+				{
+					queue.pageReady.wait( &queue.mutex );
+				}
+				QPicture picture = queue.pages.take( iPage );
+				queue.iNextPage = iPage + 1;
+				queue.pageTaken.wakeAll();
+				queue.mutex.unlock();
+
 				if ( iPage )
 				{
 					printer->newPage();
 				}
+				painter.drawPicture( 0, 0, picture );
+			}
 
-				printPage( &painter, iPage );
+			foreach ( PageWorker* worker, workers )
+			{
+				worker->wait();
 			}
+			qDeleteAll( workers );
+		}
+
+
+		///
+		/// Setup printer page to match template
+		///
+		void PageRenderer::setupPrinter( QPrinter* printer ) const
+		{
+			QSizeF pageSize( mModel->tmplate()->pageWidth().pt(), mModel->tmplate()->pageHeight().pt() );
+			printer->setPageSize( QPageSize(pageSize, QPageSize::Point) );
+			printer->setFullPage( true );
+			printer->setPageMargins( 0, 0, 0, 0, QPrinter::Point );
+		}
+
+
+		///
+		/// Scale painter so that it draws in points
+		///
+		void PageRenderer::scaleToPoints( QPrinter* printer, QPainter* painter ) const
+		{
+			QRectF rectPx  = printer->paperRect( QPrinter::DevicePixel );
+			QRectF rectPts = printer->paperRect( QPrinter::Point );
+			painter->scale( rectPx.width()/rectPts.width(), rectPx.height()/rectPts.height() );
+		}
+
+
+		///
+		/// Create renderer with private copies of model and variables
+		///
+		/// The render path mutates variables and object state, so each worker
+		/// thread needs its own copy.  The merge source is only read and is shared,
+		/// unless cloneMerge is set: a worker that can outlive a change of merge
+		/// in the original model needs its own copy of the records.
+		/// The caller owns the returned renderer, its model and the model's
+		/// variables, and the model's merge if cloned.
+		///
+		PageRenderer* PageRenderer::cloneForWorker( bool cloneMerge ) const
+		{
+			merge::Merge* merge = cloneMerge ? mModel->merge()->clone() : mModel->merge();
+
+			auto* model = new Model( merge, mModel->variables()->clone() );
+			model->restore( mModel );
+
+			auto* renderer = new PageRenderer( model );
+			renderer->mNCopies        = mNCopies;
+			renderer->mStartLabel     = mStartLabel;
+			renderer->mPrintOutlines  = mPrintOutlines;
+			renderer->mPrintCropMarks = mPrintCropMarks;
+			renderer->mPrintReverse   = mPrintReverse;
+			renderer->mLabelCache     = mLabelCache;
+			renderer->mIPage          = mIPage;
+			renderer->updateNPages();
+
+			return renderer;
 		}
 
 
@@ -233,86 +449,105 @@ namespace glabels
 		{
 			if ( mModel )
 			{
-				if ( mIsMerge )
-				{
-					printMergePage( painter, iPage );
-				}
-				else
-				{
-					printSimplePage( painter, iPage );
-				}
+				printPages( painter, nullptr, iPage, iPage+1 );
 			}
 		}
 
 
-		void PageRenderer::printSimplePage( QPainter* painter, int iPage ) const
+		///
+		/// Print range of pages [iFirstPage,iLastPage)
+		///
+		/// Labels, records and variables are walked exactly once, starting from the
+		/// closest page checkpoint at or before iFirstPage.  A checkpoint is saved
+		/// at the start of every page reached along the way, so later requests for
+		/// any of those pages only replay that page.  If printer is not null, a new
+		/// printer page is started between consecutive pages.
+		///
+		void PageRenderer::printPages( QPainter* painter,
+		                               QPrinter* printer,
+		                               int       iFirstPage,
+		                               int       iLastPage ) const
 		{
-			printCropMarks( painter );
+			if ( !mModel || (iFirstPage >= iLastPage) )
+			{
+				return;
+			}
 
-			int iCopy = 0;
-			int iLabel = mStartLabel;
-			int iCurrentPage = 0;
-			mVariables->resetVariables();
+			bool isStreaming = mIsMerge && mMerge->isStreaming();
+			QList<merge::Record*> records;
+			merge::Record streamedRecord;
+			int nRecords;
 
-			while ( (iCopy < mNCopies) && (iCurrentPage <= iPage) )
+			if ( mIsMerge )
 			{
-				if ( iCurrentPage == iPage )
+				if ( isStreaming )
 				{
-					int i = iLabel % mNLabelsPerPage;
-					
-					painter->save();
-
-					painter->translate( mOrigins[i].x().pt(), mOrigins[i].y().pt() );
-			
-					painter->save();
-
-					clipLabel( painter );
-					printLabel( painter, nullptr, mVariables );
-
-					painter->restore();  // From before clip
-
-					printOutline( painter );
-			
-					painter->restore();  // From before translation
+					// Records are read on demand, only for labels actually drawn
+					nRecords = mMerge->nSelectedRecords();
+				}
+				else
+				{
+					records = mMerge->selectedRecords();
+					nRecords = records.size();
 				}
 
-				iCopy++;
-				iLabel++;
-				iCurrentPage = iLabel / mNLabelsPerPage;
-
-				mVariables->incrementVariablesOnItem();
-				mVariables->incrementVariablesOnCopy();
-				if ( (iLabel % mNLabelsPerPage) == 0 /* starting a new page */ )
+				if ( nRecords == 0 )
 				{
-					mVariables->incrementVariablesOnPage();
+					// Nothing to merge: pages only get crop marks
+					for ( int iPage = iFirstPage; iPage < iLastPage; iPage++ )
+					{
+						startPage( painter, printer, iPage, iFirstPage );
+					}
+					return;
 				}
 			}
-		}
+			else
+			{
+				// Simple labels behave like a merge of a single, empty record
+				records << nullptr;
+				nRecords = 1;
+			}
 
-	
-		void PageRenderer::printMergePage( QPainter* painter, int iPage ) const
-		{
-			printCropMarks( painter );
+			if ( mCheckpoints.isEmpty() )
+			{
+				mVariables->resetVariables();
+				mCheckpoints.append( { 0, 0, *mVariables } );
+			}
 
-			int iCopy = 0;
-			int iLabel = mStartLabel;
-			int iCurrentPage = 0;
+			// Resume from closest checkpoint
+			int iPage = qMin( iFirstPage, mCheckpoints.size() - 1 );
+			const PageCheckpoint& checkpoint = mCheckpoints[iPage];
 
-			const QList<merge::Record*> records = mMerge->selectedRecords();
-			int iRecord = 0;
-			int nRecords = records.size();
+			int iCopy   = checkpoint.iCopy;
+			int iRecord = checkpoint.iRecord;
+			int iLabel  = (iPage == 0) ? mStartLabel : iPage*mNLabelsPerPage;
+			static_cast<QMap<QString,Variable>&>( *mVariables ) = checkpoint.variables;
 
-			if ( nRecords == 0 )
+			if ( iPage == iFirstPage )
 			{
-				return;
+				startPage( painter, printer, iPage, iFirstPage );
 			}
-			
-			mVariables->resetVariables();
 
-			while ( (iCopy < mNCopies) && (iCurrentPage <= iPage) )
+			while ( (iCopy < mNCopies) && (iPage < iLastPage) )
 			{
-				if ( iCurrentPage == iPage )
+				if ( mAbortFlag && mAbortFlag->load() )
+				{
+					break;
+				}
+
+				if ( iPage >= iFirstPage )
 				{
+					merge::Record* record;
+					if ( isStreaming )
+					{
+						mMerge->readSelectedRecord( iRecord, streamedRecord );
+						record = &streamedRecord;
+					}
+					else
+					{
+						record = records[iRecord];
+					}
+
 					int i = iLabel % mNLabelsPerPage;
 					
 					painter->save();
@@ -322,7 +557,7 @@ namespace glabels
 					painter->save();
 
 					clipLabel( painter );
-					printLabel( painter, records[iRecord], mVariables );
+					printLabel( painter, record, mVariables );
 
 					painter->restore();  // From before clip
 
@@ -337,7 +572,6 @@ namespace glabels
 					iCopy++;
 				}
 				iLabel++;
-				iCurrentPage = iLabel / mNLabelsPerPage;
 
 				mVariables->incrementVariablesOnItem();
 				if ( iRecord == 0 )
@@ -347,9 +581,37 @@ namespace glabels
 				if ( (iLabel % mNLabelsPerPage) == 0 /* starting a new page */ )
 				{
 					mVariables->incrementVariablesOnPage();
+
+					iPage = iLabel / mNLabelsPerPage;
+					if ( iPage == mCheckpoints.size() )
+					{
+						mCheckpoints.append( { iCopy, iRecord, *mVariables } );
+					}
+
+					if ( (iPage >= iFirstPage) && (iPage < iLastPage) && (iCopy < mNCopies) )
+					{
+						startPage( painter, printer, iPage, iFirstPage );
+					}
 				}
 			}
 		}
+
+
+		///
+		/// Start a new page
+		///
+		void PageRenderer::startPage( QPainter* painter,
+		                              QPrinter* printer,
+		                              int       iPage,
+		                              int       iFirstPage ) const
+		{
+			if ( printer && (iPage > iFirstPage) )
+			{
+				printer->newPage();
+			}
+
+			printCropMarks( painter );
+		}
 	
 	
 		void PageRenderer::printCropMarks( QPainter* painter ) const
@@ -451,7 +713,33 @@ namespace glabels
 				painter->scale( -1, 1 );
 			}
 
-			mModel->draw( painter, false, record, variables );
+			if ( mLabelCache )
+			{
+				QString key = mModel->contentKey( record, variables );
+
+				QPicture* picture = mLabelPictures.object( key );
+				if ( picture )
+				{
+					painter->drawPicture( 0, 0, *picture );
+				}
+				else
+				{
+					picture = new QPicture();
+
+					QPainter picturePainter( picture );
+					mModel->draw( &picturePainter, false, record, variables );
+					picturePainter.end();
+
+					painter->drawPicture( 0, 0, *picture );
+
+					// Charged by size; a picture larger than the whole cache is deleted at once
+					mLabelPictures.insert( key, picture, int( picture->size() / 1024 ) + 1 );
+				}
+			}
+			else
+			{
+				mModel->draw( painter, false, record, variables );
+			}
 
 			painter->restore();
 		}
@@ -28,7 +28,11 @@
 #include "merge/Merge.h"
 #include "merge/Record.h"
 
+#include <QAtomicInt>
+#include <QCache>
+#include <QMap>
 #include <QPainter>
+#include <QPicture>
 #include <QPrinter>
 #include <QRect>
 #include <QVector>
@@ -68,13 +72,17 @@ namespace glabels
 			void setPrintOutlines( bool printOutlinesFlag );
 			void setPrintCropMarks( bool printCropMarksFlag );
 			void setPrintReverse( bool printReverseFlag );
+			void setLabelCache( bool labelCacheFlag );
 			void setIPage( int iPage );
+			void setAbortFlag( const QAtomicInt* abortFlag );
 			int nItems() const;
 			int nPages() const;
 			QRectF pageRect() const;
 			void print( QPrinter* printer ) const;
+			void print( QPrinter* printer, int nJobs ) const;
 			void printPage( QPainter* painter ) const;
 			void printPage( QPainter* painter, int iPage ) const;
+			PageRenderer* cloneForWorker( bool cloneMerge = false ) const;
 
 
 			/////////////////////////////////
@@ -96,8 +104,11 @@ namespace glabels
 			/////////////////////////////////
 		private:
 			void updateNPages();
-			void printSimplePage( QPainter* painter, int iPage ) const;
-			void printMergePage( QPainter* painter, int iPage ) const;
+			void setupPrinter( QPrinter* printer ) const;
+			void scaleToPoints( QPrinter* printer, QPainter* painter ) const;
+			void clearCheckpoints();
+			void printPages( QPainter* painter, QPrinter* printer, int iFirstPage, int iLastPage ) const;
+			void startPage( QPainter* painter, QPrinter* printer, int iPage, int iFirstPage ) const;
 			void printCropMarks( QPainter* painter ) const;
 			void printOutline( QPainter* painter ) const;
 			void clipLabel( QPainter* painter ) const;
@@ -118,13 +129,29 @@ namespace glabels
 			bool              mPrintOutlines;
 			bool              mPrintCropMarks;
 			bool              mPrintReverse;
+			bool              mLabelCache;
 			int               mIPage;
+			const QAtomicInt* mAbortFlag;
 
 			bool              mIsMerge;
 			int               mNPages;
 			int               mNLabelsPerPage;
 
 			QVector<Point>    mOrigins;
+
+			///
+			/// Label iteration state at the start of a page
+			///
+			struct PageCheckpoint
+			{
+				int                    iCopy;
+				int                    iRecord;
+				QMap<QString,Variable> variables;
+			};
+
+			mutable QVector<PageCheckpoint> mCheckpoints;
+
+			mutable QCache<QString,QPicture> mLabelPictures;
 		};
 
 	}
@@ -27,10 +27,19 @@ namespace glabels
 	namespace model
 	{
 
+		///
+		/// Default constructor
+		///
+		RawText::RawText() : mLiteralLength(0)
+		{
+			// empty
+		}
+
+
 		///
 		/// Constructor from QString
 		///
-		RawText::RawText( const QString& string ) : mString(string)
+		RawText::RawText( const QString& string ) : mString(string), mLiteralLength(0)
 		{
 			tokenize();
 		}
@@ -39,7 +48,7 @@ namespace glabels
 		///
 		/// Constructor from C string operator
 		///
-		RawText::RawText( const char* cString ) : mString(QString(cString))
+		RawText::RawText( const char* cString ) : mString(QString(cString)), mLiteralLength(0)
 		{
 			tokenize();
 		}
@@ -69,12 +78,16 @@ namespace glabels
 		QString RawText::expand( merge::Record* record, Variables* variables ) const
 		{
 			QString text;
-		
-			foreach ( const Token& token, mTokens )
+			text.reserve( mLiteralLength + 16*mTokens.size() );
+
+			for ( int i = 0; i < mTokens.size(); i++ )
 			{
+				const Token& token = mTokens[i];
+
 				if ( token.isField )
 				{
-					text += token.field.evaluate( record, variables );
+					int iColumn = mBindings[i].column( record, token.field.fieldName() );
+					text += token.field.evaluate( record, iColumn, variables );
 				}
 				else
 				{
@@ -144,7 +157,15 @@ namespace glabels
 				token.isField = false;
 				mTokens.append( token );
 			}
-				
+
+			for ( int i = 0; i < mTokens.size(); i++ )
+			{
+				if ( !mTokens[i].isField )
+				{
+					mLiteralLength += mTokens[i].text.size();
+				}
+			}
+			mBindings.resize( mTokens.size() );
 		}
 
 	
@@ -22,9 +22,11 @@
 #define model_RawText_h
 
 
+#include "ColumnBinding.h"
 #include "SubstitutionField.h"
 
 #include <QString>
+#include <QVector>
 
 
 namespace glabels
@@ -35,6 +37,10 @@ namespace glabels
 		///
 		/// Raw Text Type
 		///
+		/// The text is tokenized once, when assigned.  Expansion then only binds
+		/// field tokens to record columns (refreshed when the merge source's keys
+		/// change) and concatenates the pieces into a pre-sized string.
+		///
 		struct RawText
 		{
 
@@ -42,7 +48,7 @@ namespace glabels
 			// Life Cycle
 			/////////////////////////////////
 		public:
-			RawText() = default;
+			RawText();
 			RawText( const QString& string );
 			RawText( const char* cString );
 
@@ -77,6 +83,9 @@ namespace glabels
 			};
 		
 			QList<Token> mTokens;
+			int          mLiteralLength;
+
+			mutable QVector<ColumnBinding> mBindings; // One per token
 
 		};
 
@@ -295,6 +295,51 @@ namespace glabels
 		}
 
 
+		int Settings::compressionLevel()
+		{
+			// Uncompressed by default, readable by any version and tool
+			int defaultValue = 0;
+
+			mInstance->beginGroup( "Files" );
+			int returnValue = mInstance->value( "compressionLevel", defaultValue ).toInt();
+			mInstance->endGroup();
+
+			return qBound( 0, returnValue, 9 );
+		}
+
+
+		void Settings::setCompressionLevel( int compressionLevel )
+		{
+			mInstance->beginGroup( "Files" );
+			mInstance->setValue( "compressionLevel", compressionLevel );
+			mInstance->endGroup();
+
+			emit mInstance->changed();
+		}
+
+
+		int Settings::maxUndoLevels()
+		{
+			int defaultValue = 100;
+
+			mInstance->beginGroup( "Edit" );
+			int returnValue = mInstance->value( "maxUndoLevels", defaultValue ).toInt();
+			mInstance->endGroup();
+
+			return qMax( 1, returnValue );
+		}
+
+
+		void Settings::setMaxUndoLevels( int maxUndoLevels )
+		{
+			mInstance->beginGroup( "Edit" );
+			mInstance->setValue( "maxUndoLevels", maxUndoLevels );
+			mInstance->endGroup();
+
+			emit mInstance->changed();
+		}
+
+
 		int Settings::maxRecentFiles()
 		{
 			return mMaxRecentFiles;
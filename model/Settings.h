@@ -90,6 +90,12 @@ namespace glabels
 			static QStringList recentTemplateList();
 			static void addToRecentTemplateList( const QString& name );
 
+			static int compressionLevel();
+			static void setCompressionLevel( int compressionLevel );
+
+			static int maxUndoLevels();
+			static void setMaxUndoLevels( int maxUndoLevels );
+
 			static int maxRecentFiles();
 			static QStringList recentFileList();
 			static void addToRecentFileList( const QString& filePath );
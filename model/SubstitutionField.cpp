@@ -44,19 +44,26 @@ namespace glabels
 
 		QString SubstitutionField::evaluate( const merge::Record* record,
 		                                     const Variables* variables ) const
+		{
+			return evaluate( record, record ? record->column(mFieldName) : -1, variables );
+		}
+
+
+		QString SubstitutionField::evaluate( const merge::Record* record,
+		                                     int                  iColumn,
+		                                     const Variables*     variables ) const
 		{
 			QString value = mDefaultValue;
 
 			bool haveRecordField = record &&
-				record->contains(mFieldName) &&
-				!record->value(mFieldName).isEmpty();
+				!record->valueAt(iColumn).isEmpty();
 			bool haveVariable = variables &&
 				variables->contains(mFieldName) &&
 				!(*variables)[mFieldName].value().isEmpty();
 
 			if ( haveRecordField )
 			{
-				value = record->value(mFieldName);
+				value = record->valueAt(iColumn);
 			}
 			else if ( haveVariable )
 			{
@@ -223,6 +230,8 @@ namespace glabels
 
 			parseFormatType( s, field );
 
+			field.mFormatSpec = field.mFormat.toUtf8();
+
 			return true; // Don't let invalid formats kill entire SubstitutionField
 		}
 
@@ -303,7 +312,7 @@ namespace glabels
 				
 			case 'd':
 			case 'i':
-				return QString::asprintf( mFormat.toStdString().c_str(),
+				return QString::asprintf( mFormatSpec.constData(),
 				                          value.toLongLong(nullptr,0) );
 				break;
 				
@@ -312,7 +321,7 @@ namespace glabels
 			case 'x':
 			case 'X':
 			case 'o':
-				return QString::asprintf( mFormat.toStdString().c_str(),
+				return QString::asprintf( mFormatSpec.constData(),
 				                          value.toULongLong(nullptr,0) );
 				break;
 
@@ -322,13 +331,13 @@ namespace glabels
 			case 'E':
 			case 'g':
 			case 'G':
-				return QString::asprintf( mFormat.toStdString().c_str(),
+				return QString::asprintf( mFormatSpec.constData(),
 				                          value.toDouble() );
 				break;
 
 			case 's':
-				return QString::asprintf( mFormat.toStdString().c_str(),
-				                          value.toStdString().c_str() );
+				return QString::asprintf( mFormatSpec.constData(),
+				                          value.toUtf8().constData() );
 				break;
 
 			default:
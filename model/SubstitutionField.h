@@ -25,6 +25,7 @@
 
 #include "merge/Record.h"
 
+#include <QByteArray>
 #include <QString>
 #include <QStringRef>
 
@@ -41,6 +42,7 @@ namespace glabels
 			SubstitutionField( const QString& string );
 
 			QString evaluate( const merge::Record* record, const Variables* variables ) const;
+			QString evaluate( const merge::Record* record, int iColumn, const Variables* variables ) const;
 		
 			QString fieldName() const;
 			QString defaultValue() const;
@@ -68,8 +70,9 @@ namespace glabels
 
 			QString mDefaultValue;
 
-			QString mFormat;
-			QChar   mFormatType;
+			QString    mFormat;
+			QByteArray mFormatSpec; // mFormat, ready for asprintf()
+			QChar      mFormatType;
 
 			bool    mNewLine;
 		};
@@ -310,6 +310,12 @@ namespace glabels
 		}
 
 
+		const QStringList& Template::categoryIds() const
+		{
+			return mCategoryIds;
+		}
+
+
 		bool Template::hasCategory( const QString& categoryId ) const
 		{
 			foreach ( QString testCategoryId, mCategoryIds )
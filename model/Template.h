@@ -95,6 +95,8 @@ namespace glabels
 			void addCategory( const QString& categoryId );
 			void addFrame( Frame* frame );
 
+			const QStringList& categoryIds() const;
+
 			const QList<Frame*>& frames() const;
 
 			bool operator==( const Template& other ) const;
@@ -110,16 +110,17 @@ namespace glabels
 		{
 			QString value("");
 			
+			int iColumn = mIsField ? mColumn.column( record, mData ) : -1;
+
 			bool haveRecordField = mIsField && record &&
-				record->contains(mData) &&
-				!record->value(mData).isEmpty();
+				!record->valueAt(iColumn).isEmpty();
 			bool haveVariable = mIsField && variables &&
 				variables->contains(mData) &&
 				!(*variables)[mData].value().isEmpty();
 
 			if ( haveRecordField )
 			{
-				value = record->value(mData);
+				value = record->valueAt(iColumn);
 			}
 			else if ( haveVariable )
 			{
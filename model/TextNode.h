@@ -22,6 +22,7 @@
 #define model_TextNode_h
 
 
+#include "ColumnBinding.h"
 #include "Variables.h"
 #include "merge/Record.h"
 
@@ -89,6 +90,8 @@ namespace glabels
 			bool    mIsField;
 			QString mData;
 
+			mutable ColumnBinding mColumn;
+
 		};
 
 	}
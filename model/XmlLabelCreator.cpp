@@ -42,19 +42,55 @@
 #include <QTextBlock>
 #include <QTextDocument>
 #include <QBuffer>
+#include <QTextStream>
 #include <QtDebug>
 
+#if HAVE_ZLIB
+#include "GzipDevice.h"
+#endif
+
 
 namespace glabels
 {
 	namespace model
 	{
 
+		//
+		// Private
+		//
+		namespace
+		{
+			///
+			/// Write document to device, as UTF-8 indented by 2
+			///
+			void saveDoc( const QDomDocument& doc, QIODevice* device )
+			{
+				QTextStream stream( device );
+				stream.setCodec( "UTF-8" );
+				doc.save( stream, 2 );
+			}
+		}
+
+
+		///
+		/// Write project file
+		///
+		/// A compressionLevel of 1-9 writes a gzip compressed file, 0 writes plain XML.
+		///
 		void
-		XmlLabelCreator::writeFile( Model* model, const QString& fileName )
+		XmlLabelCreator::writeFile( Model* model, const QString& fileName, int compressionLevel )
 		{
+#if !HAVE_ZLIB
+			if ( compressionLevel > 0 )
+			{
+				qWarning() << "Warning: Cannot write compressed glabels project file!  gLabels not built with ZLIB.";
+				compressionLevel = 0;
+			}
+#endif
+
 			QFile file( fileName );
-			if ( !file.open( QFile::WriteOnly | QFile::Text) )
+			QIODevice::OpenMode mode = (compressionLevel > 0) ? QFile::WriteOnly : (QFile::WriteOnly | QFile::Text);
+			if ( !file.open( mode ) )
 			{
 				qWarning() << "Error: Cannot write file " << fileName
 				           << ": " << file.errorString();
@@ -67,8 +103,24 @@ namespace glabels
 			QDomDocument doc;
 			createDoc( doc, model );
 
-			QByteArray buffer = doc.toByteArray( 2 );
-			file.write( buffer.data(), buffer.size() );
+#if HAVE_ZLIB
+			if ( compressionLevel > 0 )
+			{
+				// Compressed as it is written, never holding the whole document
+				GzipDevice gzipDevice( &file, qMin( compressionLevel, 9 ) );
+				if ( !gzipDevice.open( QIODevice::WriteOnly ) )
+				{
+					qWarning() << "Error: Cannot write file " << fileName
+					           << ": " << gzipDevice.errorString();
+					return;
+				}
+
+				saveDoc( doc, &gzipDevice );
+				return;
+			}
+#endif
+
+			saveDoc( doc, &file );
 		}
 
 
@@ -554,7 +606,7 @@ namespace glabels
 			foreach ( QString name, data.imageNames() )
 			{
 				QString fn = FileUtil::makeRelativeIfInDir( model->dir(), name );
-				createPngFileNode( node, fn, data.getImage( name ) );
+				createPngFileNode( node, fn, data.getImage( name ), data.getImageData( name ) );
 			}
 
 			foreach ( QString name, data.svgNames() )
@@ -566,7 +618,10 @@ namespace glabels
 
 
 		void
-		XmlLabelCreator::createPngFileNode( QDomElement &parent, const QString& name, const QImage& image )
+		XmlLabelCreator::createPngFileNode( QDomElement&      parent,
+		                                    const QString&    name,
+		                                    const QImage&     image,
+		                                    const QByteArray& pngData )
 		{
 			QDomDocument doc = parent.ownerDocument();
 			QDomElement node = doc.createElement( "File" );
@@ -576,10 +631,14 @@ namespace glabels
 			XmlUtil::setStringAttr( node, "mimetype", "image/png" );
 			XmlUtil::setStringAttr( node, "encoding", "base64" );
 
-			QByteArray ba;
-			QBuffer buffer(&ba);
-			buffer.open(QIODevice::WriteOnly);
-			image.save(&buffer, "PNG");
+			// Write original encoding through when known, re-encoding is slow
+			QByteArray ba = pngData;
+			if ( ba.isEmpty() )
+			{
+				QBuffer buffer(&ba);
+				buffer.open(QIODevice::WriteOnly);
+				image.save(&buffer, "PNG");
+			}
 			QByteArray ba64 = ba.toBase64();
 
 			node.appendChild( doc.createTextNode( QString( ba64 ) ) );
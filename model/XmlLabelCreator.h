@@ -52,7 +52,8 @@ namespace glabels
 
 		public:
 			static void writeFile( Model*         model,
-			                       const QString& fileName );
+			                       const QString& fileName,
+			                       int            compressionLevel = 0 );
 			
 			static void writeBuffer( const Model* model,
 			                         QByteArray&  buffer );
@@ -125,9 +126,10 @@ namespace glabels
 			                            const Model*               model,
 			                            const QList<ModelObject*>& objects );
 			
-			static void createPngFileNode( QDomElement&   parent,
-			                               const QString& name,
-			                               const QImage&  image );
+			static void createPngFileNode( QDomElement&      parent,
+			                               const QString&    name,
+			                               const QImage&     image,
+			                               const QByteArray& pngData );
 			
 			static void createSvgFileNode( QDomElement&      parent,
 			                               const QString&    name,
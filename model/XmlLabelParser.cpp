@@ -44,14 +44,127 @@
 #include <QtDebug>
 
 #if HAVE_ZLIB
-#include <zlib.h>
+#include "GunzipDevice.h"
 #endif
 
+
 namespace glabels
 {
 	namespace model
 	{
 
+		//
+		// Private
+		//
+		namespace
+		{
+			const int base64ChunkSize = 64 * 1024; // Must be a multiple of 4
+
+
+			///
+			/// Incremental base64 decoder
+			///
+			/// Like QByteArray::fromBase64(), ignores characters outside of the
+			/// base64 alphabet, but decodes as text arrives in fixed size chunks.
+			///
+			class Base64Decoder
+			{
+			public:
+				Base64Decoder()
+				{
+					mPending.reserve( base64ChunkSize );
+				}
+
+				void addData( const QStringRef& text )
+				{
+					for ( int i = 0; i < text.size(); i++ )
+					{
+						ushort c = text.at( i ).unicode();
+						if ( ((c >= 'A') && (c <= 'Z')) ||
+						     ((c >= 'a') && (c <= 'z')) ||
+						     ((c >= '0') && (c <= '9')) ||
+						     (c == '+') || (c == '/') || (c == '=') )
+						{
+							mPending.append( char(c) );
+							if ( mPending.size() == base64ChunkSize )
+							{
+								flush();
+							}
+						}
+					}
+				}
+
+				QByteArray result()
+				{
+					flush();
+					return mDecoded;
+				}
+
+			private:
+				void flush()
+				{
+					mDecoded.append( QByteArray::fromBase64( mPending ) );
+					mPending.clear();
+				}
+
+				QByteArray mPending;
+				QByteArray mDecoded;
+			};
+
+
+			///
+			/// Advance to next chunk of character data of current element
+			///
+			/// Returns false once the end of the element is reached.
+			///
+			bool readNextText( QXmlStreamReader& reader )
+			{
+				while ( !reader.atEnd() )
+				{
+					switch ( reader.readNext() )
+					{
+					case QXmlStreamReader::Characters:
+						return true;
+
+					case QXmlStreamReader::StartElement:
+						reader.skipCurrentElement();
+						break;
+
+					case QXmlStreamReader::EndElement:
+						return false;
+
+					default:
+						break;
+					}
+				}
+
+				return false;
+			}
+
+
+			///
+			/// Read remainder of document, to catch any trailing errors
+			///
+			bool finishDocument( QXmlStreamReader& reader )
+			{
+				while ( !reader.atEnd() )
+				{
+					reader.readNext();
+				}
+
+				if ( reader.hasError() )
+				{
+					qWarning() << "Error: Parse error at line " << reader.lineNumber()
+					           << "column " << reader.columnNumber()
+					           << ": " << reader.errorString();
+					return false;
+				}
+
+				return true;
+			}
+		}
+
+
 		Model*
 		XmlLabelParser::readFile( const QString& fileName )
 		{
@@ -64,75 +177,38 @@ namespace glabels
 				return nullptr;
 			}
 
-			QDomDocument doc;
-			bool         success;
-			QString      errorString;
-			int          errorLine;
-			int          errorColumn;
-
-			QByteArray rawData = file.readAll();
-			if ( ((rawData[0]&0xFF) == 0x1F) && ((rawData[1]&0xFF) == 0x8b) ) // gzip magic number 0x1F, 0x8B
+			QByteArray magic = file.peek( 2 );
+			if ( (magic.size() == 2) && ((magic[0]&0xFF) == 0x1F) && ((magic[1]&0xFF) == 0x8b) ) // gzip magic number 0x1F, 0x8B
 			{
 #if HAVE_ZLIB
-				// gzip compressed format
-				QByteArray unzippedData;
-				gunzip( rawData, unzippedData );
-				success = doc.setContent( unzippedData, false, &errorString, &errorLine, &errorColumn );
+				// gzip compressed format, inflated as the reader consumes it
+				GunzipDevice gunzipDevice( &file );
+				if ( !gunzipDevice.open( QIODevice::ReadOnly ) )
+				{
+					qWarning() << "Error: Cannot read file" << fileName
+					           << ":" << gunzipDevice.errorString();
+					return nullptr;
+				}
+
+				QXmlStreamReader reader( &gunzipDevice );
+				return parseDocument( reader, fileName );
 #else
 				qWarning() << "Warning: Cannot read compressed glabels project file!  gLabels not built with ZLIB.";
 				return nullptr;
 #endif
 			}
-			else
-			{
-				// plain text
-				success = doc.setContent( rawData, false, &errorString, &errorLine, &errorColumn );
-			}
 
-			if ( !success )
-			{
-				qWarning() << "Error: Parse error at line " << errorLine
-				           << "column " << errorColumn
-				           << ": " << errorString;
-				return nullptr;
-			}
-	
-
-			QDomElement root = doc.documentElement();
-			if ( root.tagName() != "Glabels-document" )
-			{
-				qWarning() << "Error: Not a Glabels-document file";
-				return nullptr;
-			}
-
-			return parseRootNode( root, fileName );
+			// plain text
+			QXmlStreamReader reader( &file );
+			return parseDocument( reader, fileName );
 		}
 
 
 		Model*
 		XmlLabelParser::readBuffer( const QByteArray& buffer )
 		{
-			QDomDocument doc;
-			QString      errorString;
-			int          errorLine;
-			int          errorColumn;
-
-			if ( !doc.setContent( buffer, false, &errorString, &errorLine, &errorColumn ) )
-			{
-				qWarning() << "Error: Parse error at line " << errorLine
-				           << "column " << errorColumn
-				           << ": " << errorString;
-				return nullptr;
-			}
-
-			QDomElement root = doc.documentElement();
-			if ( root.tagName() != "Glabels-document" )
-			{
-				qWarning() << "Error: Not a Glabels-document file";
-				return nullptr;
-			}
-
-			return parseRootNode( root, QString() );
+			QXmlStreamReader reader( buffer );
+			return parseDocument( reader, QString() );
 		}
 
 
@@ -140,109 +216,94 @@ namespace glabels
 		XmlLabelParser::deserializeObjects( const QByteArray& buffer, const Model* model )
 		{
 			QList<ModelObject*> list;
-	
-			QDomDocument doc;
-			QString      errorString;
-			int          errorLine;
-			int          errorColumn;
 
-			if ( !doc.setContent( buffer, false, &errorString, &errorLine, &errorColumn ) )
+			QXmlStreamReader reader( buffer );
+			reader.setNamespaceProcessing( false );
+
+			if ( !reader.readNextStartElement() )
 			{
-				qWarning() << "Error: Parse error at line " << errorLine
-				           << "column " << errorColumn
-				           << ": " << errorString;
+				finishDocument( reader );
 				return list;
 			}
 
-			QDomElement root = doc.documentElement();
-			if ( root.tagName() != "Glabels-objects" )
+			if ( reader.qualifiedName() != "Glabels-objects" )
 			{
 				qWarning() << "Error: Not a Glabels-objects stream";
 				return list;
 			}
 
-			/* Pass 1, extract data nodes to pre-load cache. */
-			DataCache data;
-			for ( QDomNode child = root.firstChild(); !child.isNull(); child = child.nextSibling() )
+			/* Pass 1, decode data nodes into cache, set aside objects nodes. */
+			DataCache          data;
+			QDomDocument       doc;
+			QList<QDomElement> objectsNodes;
+			while ( reader.readNextStartElement() )
 			{
-				if ( child.toElement().tagName() == "Data" )
+				if ( reader.qualifiedName() == "Data" )
+				{
+					parseDataNode( reader, model, data );
+				}
+				else if ( reader.qualifiedName() == "Objects" )
 				{
-					parseDataNode( child.toElement(), model, data );
+					objectsNodes << XmlUtil::readElement( reader, doc );
 				}
+				else
+				{
+					reader.skipCurrentElement();
+				}
+			}
+
+			if ( !finishDocument( reader ) )
+			{
+				return list;
 			}
 
 			/* Pass 2, now extract objects. */
-			for ( QDomNode child = root.firstChild(); !child.isNull(); child = child.nextSibling() )
+			foreach ( const QDomElement& node, objectsNodes )
 			{
-				if ( child.toElement().tagName() == "Objects" )
-				{
-					list = parseObjectsNode( child.toElement(), model, data );
-				}
+				list = parseObjectsNode( node, model, data );
 			}
 
 			return list;
 		}
 
 
-#if HAVE_ZLIB
-		void
-		XmlLabelParser::gunzip( const QByteArray& data, QByteArray& result )
+		Model*
+		XmlLabelParser::parseDocument( QXmlStreamReader& reader, const QString& fileName )
 		{
-			result.clear();
+			reader.setNamespaceProcessing( false );
 
-			if (data.size() <= 4) {
-				qWarning("XmlLabelParser::gunzip: Input data is truncated");
-				return;
+			if ( !reader.readNextStartElement() )
+			{
+				finishDocument( reader );
+				return nullptr;
 			}
 
-			// setup stream for inflate()
-			z_stream strm;
-			strm.zalloc = Z_NULL;
-			strm.zfree = Z_NULL;
-			strm.opaque = Z_NULL;
-			strm.avail_in = data.size();
-			strm.next_in = (Bytef*)(data.data());
-
-			int ret = inflateInit2(&strm, MAX_WBITS + 16); // gzip decoding
-			if (ret != Z_OK)
+			if ( reader.qualifiedName() != "Glabels-document" )
 			{
-				return;
+				qWarning() << "Error: Not a Glabels-document file";
+				return nullptr;
 			}
 
-			static const int CHUNK_SIZE = 1024;
-			char out[CHUNK_SIZE];
-
-			// run inflate(), one chunk at a time
-			do {
-				strm.avail_out = CHUNK_SIZE;
-				strm.next_out = (Bytef*)(out);
-
-				ret = inflate(&strm, Z_NO_FLUSH);
-				Q_ASSERT(ret != Z_STREAM_ERROR);  // state not clobbered
-
-				if ( (ret == Z_NEED_DICT) || (ret == Z_DATA_ERROR) || (ret == Z_MEM_ERROR) )
-				{
-					// clean up
-					inflateEnd(&strm);
-					return;
-				}
-
-				result.append(out, CHUNK_SIZE - strm.avail_out);
-			} while (strm.avail_out == 0);
-
-			// clean up
-			inflateEnd(&strm);
+			return parseRootNode( reader, fileName );
 		}
-#endif
-		
+
 
 		Model*
-		XmlLabelParser::parseRootNode( const QDomElement &node, const QString& fileName )
+		XmlLabelParser::parseRootNode( QXmlStreamReader& reader, const QString& fileName )
 		{
-			QString version = XmlUtil::getStringAttr( node, "version", "" );
+			QString rootTagName = reader.qualifiedName().toString();
+
+			QString version = XmlUtil::getStringAttr( reader.attributes(), "version", "" );
 			if ( version != "4.0" )
 			{
 				// Attempt to import as version 3.0 format (glabels 2.0 - glabels 3.4)
+				QDomDocument doc;
+				QDomElement  node = XmlUtil::readElement( reader, doc );
+				if ( !finishDocument( reader ) )
+				{
+					return nullptr;
+				}
+
 				auto* model = XmlLabelParser_3::parseRootNode( node );
 				if ( model )
 				{
@@ -254,24 +315,39 @@ namespace glabels
 			auto* model = new Model();
 			model->setFileName( fileName );
 
-			/* Pass 1, extract data nodes to pre-load cache. */
-			DataCache data;
-			for ( QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling() )
+			/*
+			 * Pass 1, decode data nodes into cache as they are read.  Everything
+			 * else is small, so it is set aside as DOM elements.
+			 */
+			DataCache          data;
+			QDomDocument       doc;
+			QList<QDomElement> nodes;
+			while ( reader.readNextStartElement() )
 			{
-				if ( child.toElement().tagName() == "Data" )
+				if ( reader.qualifiedName() == "Data" )
+				{
+					parseDataNode( reader, model, data );
+				}
+				else
 				{
-					parseDataNode( child.toElement(), model, data );
+					nodes << XmlUtil::readElement( reader, doc );
 				}
 			}
 
+			if ( !finishDocument( reader ) )
+			{
+				delete model;
+				return nullptr;
+			}
+
 			/* Pass 2, now extract everything else. */
-			for ( QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling() )
+			foreach ( const QDomElement& child, nodes )
 			{
-				QString tagName = child.toElement().tagName();
+				QString tagName = child.tagName();
 		
 				if ( tagName == "Template" )
 				{
-					Template* tmplate = XmlTemplateParser().parseTemplateNode( child.toElement() );
+					Template* tmplate = XmlTemplateParser().parseTemplateNode( child );
 					if ( tmplate == nullptr )
 					{
 						qWarning() << "Unable to parse template";
@@ -283,8 +359,8 @@ namespace glabels
 				}
 				else if ( tagName == "Objects" )
 				{
-					model->setRotate( parseRotateAttr( child.toElement() ) );
-					auto list = parseObjectsNode( child.toElement(), model, data );
+					model->setRotate( parseRotateAttr( child ) );
+					auto list = parseObjectsNode( child, model, data );
 					foreach ( ModelObject* object, list )
 					{
 						model->addObject( object );
@@ -292,19 +368,15 @@ namespace glabels
 				}
 				else if ( tagName == "Merge" )
 				{
-					parseMergeNode( child.toElement(), model );
+					parseMergeNode( child, model );
 				}
 				else if ( tagName == "Variables" )
 				{
-					parseVariablesNode( child.toElement(), model );
+					parseVariablesNode( child, model );
 				}
-				else if ( tagName == "Data" )
-				{
-					/* Handled in pass 1. */
-				}
-				else if ( !child.isComment() )
+				else
 				{
-					qWarning() << "Unexpected" << node.tagName() << "child:" << tagName;
+					qWarning() << "Unexpected" << rootTagName << "child:" << tagName;
 				}
 			}
 
@@ -565,10 +637,12 @@ namespace glabels
 
 				if ( data.hasImage( fn ) )
 				{
-					return new ModelImageObject( x0, y0, w, h, lockAspectRatio,
-					                             filename, data.getImage( fn ),
-					                             QMatrix( a[0], a[1], a[2], a[3], a[4], a[5] ),
-					                             shadowState, shadowX, shadowY, shadowOpacity, shadowColorNode );
+					auto* object = new ModelImageObject( x0, y0, w, h, lockAspectRatio,
+					                                     filename, data.getImage( fn ),
+					                                     QMatrix( a[0], a[1], a[2], a[3], a[4], a[5] ),
+					                                     shadowState, shadowX, shadowY, shadowOpacity, shadowColorNode );
+					object->setImageData( data.getImageData( fn ) );
+					return object;
 				}
 				else if ( data.hasSvg( fn ) )
 				{
@@ -800,34 +874,35 @@ namespace glabels
 
 
 		void
-		XmlLabelParser::parseDataNode( const QDomElement &node,
-		                               const Model*       model,
-		                               DataCache&         data )
+		XmlLabelParser::parseDataNode( QXmlStreamReader& reader,
+		                               const Model*      model,
+		                               DataCache&        data )
 		{
-			for ( QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling() )
+			while ( reader.readNextStartElement() )
 			{
-				QString tagName = child.toElement().tagName();
-
-				if ( tagName == "File" )
+				if ( reader.qualifiedName() == "File" )
 				{
-					parseFileNode( child.toElement(), model, data );
+					parseFileNode( reader, model, data );
 				}
-				else if ( !child.isComment() )
+				else
 				{
-					qWarning() << "Unexpected" << node.tagName() << "child:" << tagName;
+					qWarning() << "Unexpected" << "Data" << "child:" << reader.qualifiedName().toString();
+					reader.skipCurrentElement();
 				}
 			}
 		}
 
 
 		void
-		XmlLabelParser::parseFileNode( const QDomElement& node,
-		                               const Model*       model,
-		                               DataCache&         data )
+		XmlLabelParser::parseFileNode( QXmlStreamReader& reader,
+		                               const Model*      model,
+		                               DataCache&        data )
 		{
-			QString name     = XmlUtil::getStringAttr( node, "name", "" );
-			QString mimetype = XmlUtil::getStringAttr( node, "mimetype", "image/png" );
-			QString encoding = XmlUtil::getStringAttr( node, "encoding", "base64" );
+			QXmlStreamAttributes attributes = reader.attributes();
+
+			QString name     = XmlUtil::getStringAttr( attributes, "name", "" );
+			QString mimetype = XmlUtil::getStringAttr( attributes, "mimetype", "image/png" );
+			QString encoding = XmlUtil::getStringAttr( attributes, "encoding", "base64" );
 
 			// Rewrite name as absolute file path
 			QString fn = QDir::cleanPath( model->dir().absoluteFilePath( name ) );
@@ -836,21 +911,38 @@ namespace glabels
 			{
 				if ( encoding == "base64" )
 				{
-					QByteArray ba64 = node.text().toUtf8();
-					QByteArray ba = QByteArray::fromBase64( ba64 );
+					// Decode as the text is read, never holding all of the encoded text
+					Base64Decoder decoder;
+					while ( readNextText( reader ) )
+					{
+						decoder.addData( reader.text() );
+					}
+
+					QByteArray ba = decoder.result();
 					QImage image;
 					image.loadFromData( ba, "PNG" );
 
-					data.addImage( fn, image );
+					data.addImage( fn, image, ba );
 				}
 				else
 				{
-					qWarning() << "Unexpected encoding:" << encoding << "node:" << node.tagName(); 
+					qWarning() << "Unexpected encoding:" << encoding << "node:" << "File"; 
+					reader.skipCurrentElement();
 				}
 			}
 			else if ( mimetype == "image/svg+xml" )
 			{
-				data.addSvg( fn, node.text().toUtf8() );
+				QByteArray svg;
+				while ( readNextText( reader ) )
+				{
+					svg.append( reader.text().toUtf8() );
+				}
+
+				data.addSvg( fn, svg );
+			}
+			else
+			{
+				reader.skipCurrentElement();
 			}
 		}
 
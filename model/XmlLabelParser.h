@@ -24,6 +24,7 @@
 
 #include <QObject>
 #include <QDomElement>
+#include <QXmlStreamReader>
 
 
 namespace glabels
@@ -59,11 +60,11 @@ namespace glabels
 			                                               const Model*      model );
 
 		private:
-			static void gunzip( const QByteArray& gzippedData,
-			                    QByteArray&       data );
+			static Model* parseDocument( QXmlStreamReader& reader,
+			                             const QString&    fileName );
 			
-			static Model* parseRootNode( const QDomElement& node,
-			                             const QString&     fileName );
+			static Model* parseRootNode( QXmlStreamReader& reader,
+			                             const QString&    fileName );
 			
 			static QList<ModelObject*> parseObjectsNode( const QDomElement& node,
 			                                             const Model*       model,
@@ -96,13 +97,13 @@ namespace glabels
 			static void parseVariableNode( const QDomElement& node,
 			                               Model*             model );
 			
-			static void parseDataNode( const QDomElement& node,
-			                           const Model*       model,
-			                           DataCache&         data );
+			static void parseDataNode( QXmlStreamReader& reader,
+			                           const Model*      model,
+			                           DataCache&        data );
 			
-			static void parseFileNode( const QDomElement& node,
-			                           const Model*       model,
-			                           DataCache&         data );
+			static void parseFileNode( QXmlStreamReader& reader,
+			                           const Model*      model,
+			                           DataCache&        data );
 
 		};
 
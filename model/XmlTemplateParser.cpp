@@ -35,6 +35,7 @@
 #include <QFile>
 #include <QDomDocument>
 #include <QDomNode>
+#include <QXmlStreamReader>
 #include <QtDebug>
 
 
@@ -44,6 +45,26 @@ namespace glabels
 	{
 
 		bool XmlTemplateParser::readFile( const QString &fileName, bool isUserDefined )
+		{
+			QList<Entry> entries;
+
+			if ( !readFile( fileName, isUserDefined, entries ) )
+			{
+				return false;
+			}
+
+			registerEntries( entries, isUserDefined );
+			return true;
+		}
+
+
+		///
+		/// Read templates from file, without registering them
+		///
+		/// Only reads from the template database, so may be used from worker threads
+		/// while no templates are being registered.
+		///
+		bool XmlTemplateParser::readFile( const QString &fileName, bool isUserDefined, QList<Entry>& entries )
 		{
 			QFile file( fileName );
 
@@ -55,52 +76,101 @@ namespace glabels
 			}
 
 
-			QDomDocument doc;
-			QString      errorString;
-			int          errorLine;
-			int          errorColumn;
+			QXmlStreamReader reader( &file );
+			reader.setNamespaceProcessing( false );
 
-			if ( !doc.setContent( &file, false, &errorString, &errorLine, &errorColumn ) )
+			if ( reader.readNextStartElement() && (reader.qualifiedName() != "Glabels-templates") )
 			{
-				qWarning() << "Error: Parse error at line " << errorLine
-				           << "column " << errorColumn
-				           << ": " << errorString;
+				qWarning() << "Error: Not a Glabels-templates file";
 				return false;
 			}
 
-			QDomElement root = doc.documentElement();
-			if ( root.tagName() != "Glabels-templates" )
+			// Deferred entries keep their elements, which belong to this document
+			QDomDocument doc;
+			QList<Entry> fileEntries;
+			if ( !reader.hasError() )
 			{
-				qWarning() << "Error: Not a Glabels-templates file";
+				parseRootNode( reader, doc, isUserDefined, fileEntries );
+			}
+
+			while ( !reader.atEnd() )
+			{
+				reader.readNext();
+			}
+
+			if ( reader.hasError() )
+			{
+				qWarning() << "Error: Parse error at line " << reader.lineNumber()
+				           << "column " << reader.columnNumber()
+				           << ": " << reader.errorString();
+				foreach ( const Entry& entry, fileEntries )
+				{
+					delete entry.tmplate;
+				}
 				return false;
 			}
 
-			parseRootNode( root, isUserDefined );
+			entries << fileEntries;
 			return true;
 		}
 
 
-		void XmlTemplateParser::parseRootNode( const QDomElement &node, bool isUserDefined )
+		///
+		/// Register templates read from file, in file order
+		///
+		void XmlTemplateParser::registerEntries( const QList<Entry>& entries, bool isUserDefined )
 		{
-			for ( QDomNode child = node.firstChild(); !child.isNull(); child = child.nextSibling() )
+			foreach ( const Entry& entry, entries )
+			{
+				Template *tmplate = entry.tmplate;
+				if ( entry.deferred )
+				{
+					tmplate = parseTemplateNode( entry.node, isUserDefined );
+				}
+
+				if ( tmplate != nullptr )
+				{
+					Db::registerTemplate( tmplate );
+				}
+				else
+				{
+					qWarning() << "Warning: could not create template, Ignored.";
+				}
+			}
+		}
+
+
+		void XmlTemplateParser::parseRootNode( QXmlStreamReader& reader,
+		                                       QDomDocument&     doc,
+		                                       bool              isUserDefined,
+		                                       QList<Entry>&     entries )
+		{
+			// Template elements are dropped once parsed, unless deferred
+			while ( reader.readNextStartElement() )
 			{
-				if ( child.toElement().tagName() == "Template" )
+				if ( reader.qualifiedName() == "Template" )
 				{
-					Template *tmplate = parseTemplateNode( child.toElement(), isUserDefined );
-					if ( tmplate != nullptr )
+					QDomElement node = XmlUtil::readElement( reader, doc );
+
+					Entry entry;
+					entry.tmplate  = nullptr;
+					entry.deferred = node.hasAttribute( "equiv" );
+					if ( entry.deferred )
 					{
-						Db::registerTemplate( tmplate );
+						entry.node = node;
 					}
 					else
 					{
-						qWarning() << "Warning: could not create template, Ignored.";
+						entry.tmplate = parseTemplateNode( node, isUserDefined );
 					}
+					entries << entry;
 				}
-				else if ( !child.isComment() )
+				else
 				{
 					qWarning() << "Warning: bad element: "
-					           << child.toElement().tagName()
+					           << reader.qualifiedName().toString()
 					           << ", Ignored.";
+					reader.skipCurrentElement();
 				}
 			}
 		}
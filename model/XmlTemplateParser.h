@@ -24,8 +24,11 @@
 
 #include "Template.h"
 
+#include <QDomDocument>
 #include <QDomElement>
+#include <QList>
 #include <QString>
+#include <QXmlStreamReader>
 
 
 namespace glabels
@@ -36,13 +39,31 @@ namespace glabels
 		class XmlTemplateParser
 		{
 		public:
+			///
+			/// Template read from file, but not yet registered
+			///
+			/// Equivalent templates refer to other registered templates, so their
+			/// creation is deferred until registration.
+			///
+			struct Entry
+			{
+				Template*   tmplate;
+				bool        deferred;
+				QDomElement node;      // Only kept for deferred entries
+			};
+
 			XmlTemplateParser() = default;
 
 			bool readFile( const QString &fileName, bool isUserDefined = false );
+			bool readFile( const QString &fileName, bool isUserDefined, QList<Entry>& entries );
+			void registerEntries( const QList<Entry>& entries, bool isUserDefined );
 			Template *parseTemplateNode( const QDomElement &node, bool isUserDefined = false );
 
 		private:
-			void parseRootNode( const QDomElement &node, bool isUserDefined );
+			void parseRootNode( QXmlStreamReader& reader,
+			                    QDomDocument&     doc,
+			                    bool              isUserDefined,
+			                    QList<Entry>&     entries );
 			void parseMetaNode( const QDomElement &node, Template *tmplate );
 			void parseLabelRectangleNode( const QDomElement &node, Template *tmplate );
 			void parseLabelEllipseNode( const QDomElement &node, Template *tmplate );
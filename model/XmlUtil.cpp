@@ -77,6 +77,21 @@ namespace glabels
 		}
 
 
+		QString XmlUtil::getStringAttr( const QXmlStreamAttributes& attributes,
+		                                const QString&              name,
+		                                const QString&              default_value )
+		{
+			init();
+
+			if ( !attributes.hasAttribute( name ) )
+			{
+				return default_value;
+			}
+
+			return attributes.value( name ).toString();
+		}
+
+
 		double XmlUtil::getDoubleAttr( const QDomElement& node,
 		                               const QString&     name,
 		                               double             default_value )
@@ -663,6 +678,52 @@ namespace glabels
 			node.setAttribute( name, pathString );
 		}
 
+
+		///
+		/// Copy element at current StartElement of reader, with its subtree, into doc
+		///
+		/// Like QDomDocument::setContent(), drops whitespace-only text.  Lets streaming
+		/// parsers hand small elements to the QDomElement based parse functions.
+		///
+		QDomElement XmlUtil::readElement( QXmlStreamReader& reader,
+		                                  QDomDocument&     doc )
+		{
+			QDomElement node = doc.createElement( reader.qualifiedName().toString() );
+			foreach ( const QXmlStreamAttribute& attribute, reader.attributes() )
+			{
+				node.setAttribute( attribute.qualifiedName().toString(), attribute.value().toString() );
+			}
+
+			while ( !reader.atEnd() )
+			{
+				switch ( reader.readNext() )
+				{
+				case QXmlStreamReader::StartElement:
+					node.appendChild( readElement( reader, doc ) );
+					break;
+
+				case QXmlStreamReader::EndElement:
+					return node;
+
+				case QXmlStreamReader::Characters:
+					if ( !reader.isWhitespace() )
+					{
+						node.appendChild( doc.createTextNode( reader.text().toString() ) );
+					}
+					break;
+
+				case QXmlStreamReader::Comment:
+					node.appendChild( doc.createComment( reader.text().toString() ) );
+					break;
+
+				default:
+					break;
+				}
+			}
+
+			return node;
+		}
+
 	
 	}
 }
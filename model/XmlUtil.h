@@ -24,12 +24,14 @@
 
 #include "Distance.h"
 
+#include <QDomDocument>
 #include <QDomElement>
 #include <QFont>
 #include <QPainterPath>
 #include <QString>
 #include <Qt>
 #include <QTextOption>
+#include <QXmlStreamReader>
 
 #include <cstdint>
 
@@ -56,6 +58,10 @@ namespace glabels
 			                               const QString&     name,
 			                               const QString&     default_value );
 
+			static QString  getStringAttr( const QXmlStreamAttributes& attributes,
+			                               const QString&              name,
+			                               const QString&              default_value );
+
 			static double   getDoubleAttr( const QDomElement& node,
 			                               const QString&     name,
 			                               double             default_value );
@@ -147,6 +153,10 @@ namespace glabels
 			                                 const Units&        units );
 
 
+			static QDomElement readElement( QXmlStreamReader& reader,
+			                                QDomDocument&     doc );
+
+
 		
 		private:
 			Units mUnits;
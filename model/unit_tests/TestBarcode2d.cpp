@@ -0,0 +1,179 @@
+/*  TestBarcode2d.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestBarcode2d.h"
+
+#include "glbarcode/Barcode2dBase.h"
+#include "glbarcode/Renderer.h"
+
+#include <QVector>
+#include <QtDebug>
+
+#include <cmath>
+
+
+QTEST_MAIN(TestBarcode2d)
+
+
+namespace
+{
+
+	const double cellSize = 0.0625 * 72; // Minimum cell size, with quiet zone of one cell
+
+
+	///
+	/// 2D barcode of a given matrix
+	///
+	class MatrixBarcode : public glbarcode::Barcode2dBase
+	{
+	public:
+		MatrixBarcode( const glbarcode::Matrix<bool>& matrix ) : mMatrix(matrix) { }
+
+	protected:
+		bool validate( const std::string& ) override
+		{
+			return true;
+		}
+
+		bool encode( const std::string&, glbarcode::Matrix<bool>& encodedData ) override
+		{
+			encodedData.resize( mMatrix.nx(), mMatrix.ny() );
+			for ( int iy = 0; iy < mMatrix.ny(); iy++ )
+			{
+				for ( int ix = 0; ix < mMatrix.nx(); ix++ )
+				{
+					encodedData[iy][ix] = mMatrix[iy][ix];
+				}
+			}
+			return true;
+		}
+
+	private:
+		glbarcode::Matrix<bool> mMatrix;
+	};
+
+
+	///
+	/// Renderer counting how many boxes cover each cell
+	///
+	class CoverageRenderer : public glbarcode::Renderer
+	{
+	public:
+		CoverageRenderer( int nx, int ny ) : nx(nx), ny(ny), nBoxes(0), coverage(nx*ny, 0) { }
+
+		void drawBegin( double, double ) override { }
+		void drawEnd() override { }
+		void drawLine( double, double, double, double ) override { }
+		void drawText( double, double, double, const std::string& ) override { }
+		void drawRing( double, double, double, double ) override { }
+		void drawHexagon( double, double, double ) override { }
+
+		void drawBox( double x, double y, double w, double h ) override
+		{
+			nBoxes++;
+
+			// Boxes must lie on cell boundaries
+			int ix0 = int( std::lround( x/cellSize ) ) - 1;
+			int iy0 = int( std::lround( y/cellSize ) ) - 1;
+			int ix1 = int( std::lround( (x+w)/cellSize ) ) - 1;
+			int iy1 = int( std::lround( (y+h)/cellSize ) ) - 1;
+			QVERIFY( std::abs( (ix0+1)*cellSize - x ) < 1e-9 );
+			QVERIFY( std::abs( (iy0+1)*cellSize - y ) < 1e-9 );
+			QVERIFY( std::abs( (ix1+1)*cellSize - (x+w) ) < 1e-9 );
+			QVERIFY( std::abs( (iy1+1)*cellSize - (y+h) ) < 1e-9 );
+
+			for ( int iy = qMax( iy0, 0 ); iy < qMin( iy1, ny ); iy++ )
+			{
+				for ( int ix = qMax( ix0, 0 ); ix < qMin( ix1, nx ); ix++ )
+				{
+					coverage[iy*nx + ix]++;
+				}
+			}
+		}
+
+		int           nx;
+		int           ny;
+		int           nBoxes;
+		QVector<int>  coverage;
+	};
+
+}
+
+
+void TestBarcode2d::vectorize_data()
+{
+	QTest::addColumn<int>( "nx" );
+	QTest::addColumn<int>( "ny" );
+	QTest::addColumn<uint>( "seed" );
+	QTest::addColumn<int>( "density" ); // Percent of dark cells
+
+	QTest::newRow( "1x1" ) << 1 << 1 << 1u << 100;
+	QTest::newRow( "all dark" ) << 24 << 24 << 2u << 100;
+	QTest::newRow( "all light" ) << 24 << 24 << 3u << 0;
+	QTest::newRow( "sparse" ) << 37 << 21 << 4u << 20;
+	QTest::newRow( "half" ) << 57 << 57 << 5u << 50;
+	QTest::newRow( "dense" ) << 144 << 144 << 6u << 80;
+}
+
+
+void TestBarcode2d::vectorize()
+{
+	QFETCH( int, nx );
+	QFETCH( int, ny );
+	QFETCH( uint, seed );
+	QFETCH( int, density );
+
+	// Deterministic pseudo-random matrix, with a solid block as in finder patterns
+	glbarcode::Matrix<bool> matrix( nx, ny );
+	int nDark = 0;
+	for ( int iy = 0; iy < ny; iy++ )
+	{
+		for ( int ix = 0; ix < nx; ix++ )
+		{
+			seed = seed*1103515245u + 12345u;
+			bool dark = ( (ix < 7) && (iy < 7) && (density > 0) ) || ( int( (seed >> 16) % 100 ) < density );
+			matrix[iy][ix] = dark;
+			nDark += dark ? 1 : 0;
+		}
+	}
+
+	MatrixBarcode barcode( matrix );
+	barcode.build( "data", 0, 0 );
+	QVERIFY( barcode.isDataValid() );
+
+	CoverageRenderer renderer( nx, ny );
+	barcode.render( renderer );
+
+	// Every dark cell is covered exactly once, and no light cell is covered
+	for ( int iy = 0; iy < ny; iy++ )
+	{
+		for ( int ix = 0; ix < nx; ix++ )
+		{
+			QCOMPARE( renderer.coverage[iy*nx + ix], matrix[iy][ix] ? 1 : 0 );
+		}
+	}
+
+	// Runs are merged
+	QVERIFY( renderer.nBoxes <= nDark );
+	if ( density == 100 )
+	{
+		QCOMPARE( renderer.nBoxes, 1 );
+	}
+}
@@ -175,3 +175,25 @@ void TestColorNode::colorNode()
 	record["c2"] = "red";
 	QCOMPARE( colorNode.color( &record, &vars ), red );
 }
+
+
+void TestColorNode::rebindKey()
+{
+	Record record;
+	record["c1"] = "red";
+	record["c2"] = "white";
+
+	ColorNode colorNode( "c1" );
+	QCOMPARE( colorNode.color( &record, nullptr ), QColor( Qt::red ) );
+
+	// Copy of a node bound to "c1", rebound against the same record
+	ColorNode copy = colorNode;
+	copy.setKey( "c2" );
+	QCOMPARE( copy.color( &record, nullptr ), QColor( Qt::white ) );
+	QCOMPARE( colorNode.color( &record, nullptr ), QColor( Qt::red ) );
+
+	colorNode.setKey( "c2" );
+	QCOMPARE( colorNode.color( &record, nullptr ), QColor( Qt::white ) );
+	colorNode.setKey( "c1" );
+	QCOMPARE( colorNode.color( &record, nullptr ), QColor( Qt::red ) );
+}
@@ -27,4 +27,5 @@ class TestColorNode : public QObject
 
 private slots:
 	void colorNode();
+	void rebindKey();
 };
@@ -0,0 +1,96 @@
+/*  TestDbSnapshot.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestDbSnapshot.h"
+
+#include "model/Db.h"
+#include "model/DbSnapshot.h"
+
+#include <QCryptographicHash>
+#include <QTemporaryDir>
+#include <QtDebug>
+
+
+QTEST_MAIN(TestDbSnapshot)
+
+using namespace glabels::model;
+
+
+void TestDbSnapshot::loadTemplateSizes()
+{
+	// Empty source directory, so that the snapshot is always current
+	QTemporaryDir sourceDir;
+	QVERIFY( sourceDir.isValid() );
+	QTemporaryDir cacheDir;
+	QVERIFY( cacheDir.isValid() );
+	QString fileName = cacheDir.filePath( "templates.snapshot" );
+
+	///
+	/// Payload: one US Letter paper and one template on it, as written by
+	/// DbSnapshot::save() before any templates are known
+	///
+	QByteArray payload;
+	{
+		QDataStream out( &payload, QIODevice::WriteOnly );
+		out.setVersion( QDataStream::Qt_5_4 );
+
+		out << quint32( 1 );
+		out << QString( "US-Letter" ) << QString( "US Letter" ) << 612.0 << 792.0 << QString( "na_letter_8.5x11in" );
+
+		out << quint32( 0 ); // Categories
+		out << quint32( 0 ); // Vendors
+
+		out << quint32( 1 );
+		out << QString( "Test Brand" ) << QString( "part" ) << QString( "desc" ) << QString( "US-Letter" );
+		out << 612.0 << 792.0 << 0.0;
+		out << QString() << QString() << QStringList();
+		out << quint32( 0 ); // Frames
+	}
+
+	{
+		QFile file( fileName );
+		QVERIFY( file.open( QIODevice::WriteOnly ) );
+
+		QDataStream out( &file );
+		out.setVersion( QDataStream::Qt_5_4 );
+
+		out << quint32( 0x474C4442 ) << quint32( 1 ); // "GLDB", version 1
+		out << QLocale().name() << QDir( sourceDir.path() ).absolutePath();
+		out << quint32( 0 ); // Sources
+		out << QCryptographicHash::hash( payload, QCryptographicHash::Md5 );
+		out << quint64( payload.size() );
+		out.writeRawData( payload.constData(), payload.size() );
+	}
+
+	///
+	/// Load into empty database
+	///
+	QVERIFY( !Db::isPaperIdKnown( "US-Letter" ) );
+
+	DbSnapshot snapshot( QDir( sourceDir.path() ), fileName );
+	QVERIFY( snapshot.load() );
+
+	QVERIFY( Db::isPaperIdKnown( "US-Letter" ) );
+	const Template* tmplate = Db::lookupTemplateFromBrandPart( "Test Brand", "part" );
+	QVERIFY( tmplate != nullptr );
+	QCOMPARE( tmplate->paperId(), QString( "US-Letter" ) );
+	QVERIFY( tmplate->isSizeUs() );
+	QVERIFY( !tmplate->isSizeIso() );
+}
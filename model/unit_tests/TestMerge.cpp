@@ -307,6 +307,152 @@ void TestMerge::text()
 }
 
 
+void TestMerge::textStreaming_data()
+{
+	text_data();
+}
+
+
+void TestMerge::textStreaming()
+{
+	QFETCH( QString, id );
+	QFETCH( bool, keyed );
+	QFETCH( char, delim );
+
+	QTemporaryFile file;
+	file.open();
+	if ( keyed )
+	{
+		file.write( "header1" );
+		file.putChar( delim );
+		file.write( "header2\r\n" );
+	}
+	file.write( "val11" );
+	file.putChar( delim );
+	file.write( "\"val\n12\"\r\n" ); // Newline within DQUOTE entry
+	file.write( "val21\n" ); // Short line
+	file.write( "val31" );
+	file.putChar( delim );
+	file.write( "val32" );
+	file.putChar( delim );
+	file.write( "val33" ); // Long line, end without CRLF
+	file.close();
+
+	Merge* merge = Factory::createMerge( id );
+	merge->setSource( file.fileName() );
+	QVERIFY( !merge->isStreaming() );
+	QCOMPARE( merge->recordList().size(), 3 );
+
+	Merge* streamedMerge = Factory::createMerge( id );
+	streamedMerge->setStreaming( true );
+	streamedMerge->setSource( file.fileName() );
+	QVERIFY( streamedMerge->isStreaming() );
+	QCOMPARE( streamedMerge->recordList().size(), 0 ); // Records not held
+	QCOMPARE( streamedMerge->nSelectedRecords(), 3 );
+	QCOMPARE( streamedMerge->keys(), merge->keys() );
+	QCOMPARE( streamedMerge->primaryKey(), merge->primaryKey() );
+
+	//
+	// Records
+	//
+	Record record;
+	for ( int i = 0; i < 3; i++ )
+	{
+		streamedMerge->readSelectedRecord( i, record );
+		QCOMPARE( record, *(merge->recordList()[i]) );
+	}
+
+	//
+	// Selection
+	//
+	streamedMerge->unselectAll();
+	QCOMPARE( streamedMerge->nSelectedRecords(), 0 );
+	streamedMerge->setSelected( 2 );
+	QCOMPARE( streamedMerge->nSelectedRecords(), 1 );
+	streamedMerge->readSelectedRecord( 0, record );
+	QCOMPARE( record, *(merge->recordList()[2]) );
+
+	streamedMerge->selectAll();
+	QCOMPARE( streamedMerge->nSelectedRecords(), 3 );
+
+	//
+	// Clone
+	//
+	Merge* cloneMerge = streamedMerge->clone();
+	QVERIFY( cloneMerge->isStreaming() );
+	QCOMPARE( cloneMerge->nSelectedRecords(), 3 );
+	cloneMerge->readSelectedRecord( 1, record );
+	QCOMPARE( record, *(merge->recordList()[1]) );
+	delete cloneMerge;
+
+	//
+	// Switch back to reading all records
+	//
+	streamedMerge->setStreaming( false );
+	QVERIFY( !streamedMerge->isStreaming() );
+	QCOMPARE( streamedMerge->recordList().size(), 3 );
+	QCOMPARE( *(streamedMerge->recordList()[1]), *(merge->recordList()[1]) );
+
+	delete streamedMerge;
+	delete merge;
+}
+
+
+void TestMerge::textLongFields_data()
+{
+	text_data();
+}
+
+
+void TestMerge::textLongFields()
+{
+	QFETCH( QString, id );
+	QFETCH( bool, keyed );
+	QFETCH( char, delim );
+
+	// Special characters well past the first 16 bytes of each field
+	QByteArray simple = "abcdefghijklmnopqrstuvwxyz0123456789";
+	QByteArray quoted = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	QTemporaryFile file;
+	file.open();
+	if ( keyed )
+	{
+		file.write( "header1" );
+		file.putChar( delim );
+		file.write( "header2\r\n" );
+	}
+	file.write( simple + "\\t" + simple + "\\" ); // Backslashed-t and backslashed-delim in long SIMPLE entry
+	file.putChar( delim );
+	file.putChar( delim );
+	file.write( simple + "\r" + simple + "\r\n" ); // CR in long SIMPLE entry
+	file.write( "\"" + quoted );
+	file.putChar( delim ); // Delimiter in long DQUOTE entry
+	file.write( quoted + "\"\"" + quoted + "\n" + quoted + "\\n" + quoted + "\"" ); // 2DQUOTE, LF, backslashed-n
+	file.putChar( delim );
+	file.write( "\"" + quoted + "\"" + simple + "\n" ); // Text concatenated after DQUOTE entry
+	file.close();
+
+	Merge* merge = Factory::createMerge( id );
+	merge->setSource( file.fileName() );
+
+	const QList<Record*>& recordList = merge->recordList();
+	QCOMPARE( recordList.size(), 2 );
+
+	const char* h1 = keyed ? "header1" : "1";
+	const char* h2 = keyed ? "header2" : "2";
+
+	QCOMPARE( recordList[0]->value( h1 ), QString( simple + "\t" + simple + delim ) );
+	QCOMPARE( recordList[0]->value( h2 ), QString( simple + simple ) );
+	QVERIFY( !recordList[0]->contains( "3" ) );
+
+	QCOMPARE( recordList[1]->value( h1 ), QString( quoted + delim + quoted + "\"" + quoted + "\n" + quoted + "\n" + quoted ) );
+	QCOMPARE( recordList[1]->value( h2 ), QString( quoted + simple ) );
+
+	delete merge;
+}
+
+
 void TestMerge::none()
 {
 	None none;
@@ -344,4 +490,31 @@ void TestMerge::record()
 	QCOMPARE( record2.isSelected(), false );
 	QVERIFY( record2.contains( "key" ) );
 	QCOMPARE( record2["key"], QString( "val" ) );
+
+	// Records share their key table, values are stored by column
+	QCOMPARE( record2.keyTable(), record.keyTable() );
+	QCOMPARE( record.column( "key" ), 0 );
+	QCOMPARE( record.column( "unknown" ), -1 );
+	QVERIFY( !record.contains( "unknown" ) );
+	QCOMPARE( record.value( "unknown" ), QString( "" ) );
+
+	record2["key2"] = "";
+	QCOMPARE( record2.column( "key2" ), 1 );
+	QVERIFY( record2.contains( "key2" ) );
+	QVERIFY( !record.contains( "key2" ) ); // Known key, but no value
+	QVERIFY( record2.hasValueAt( 1 ) );
+	QVERIFY( !record.hasValueAt( 1 ) );
+	QCOMPARE( record2.valueAt( 0 ), QString( "val" ) );
+	QVERIFY( record != record2 );
+
+	record.setValueAt( 1, "" );
+	QVERIFY( record == record2 );
+
+	Record record3;
+	record3["key2"] = "";
+	record3["key"] = "val";
+	QVERIFY( record3 == record2 ); // Different key tables, same keys and values
+	record.clear();
+	QVERIFY( !record.contains( "key" ) );
+	QCOMPARE( record.column( "key" ), 0 );
 }
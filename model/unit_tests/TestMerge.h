@@ -32,6 +32,10 @@ private slots:
 	void factoryNotRegistered();
 	void text_data();
 	void text();
+	void textStreaming_data();
+	void textStreaming();
+	void textLongFields_data();
+	void textLongFields();
 	void none();
 	void record();
 };
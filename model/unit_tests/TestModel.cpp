@@ -494,3 +494,82 @@ void TestModel::saveRestore()
 	delete saved;
 	delete modified;
 }
+
+
+void TestModel::restoreObjects()
+{
+	ColorNode black( Qt::black );
+
+	Model model;
+
+	ModelObject* object1 = new ModelBoxObject( 1, 1, 10, 10, false, 1, black, black );
+	ModelObject* object2 = new ModelBoxObject( 2, 2, 10, 10, false, 1, black, black );
+	model.addObject( object1 );
+	model.addObject( object2 );
+	QString modelShortName = model.shortName();
+
+	Model* saved = model.saveProperties();
+	QVERIFY( saved->objectList().isEmpty() );
+	QCOMPARE( saved->shortName(), modelShortName );
+
+	QPointer<ModelObject> deletedObject( object1 );
+	ModelObject* object3 = object1->clone();
+
+	model.setRotate( true );
+
+	//
+	// Test
+	//
+	model.restore( saved, { object2, object3 } );
+	QVERIFY( deletedObject.isNull() );
+	QVERIFY( !model.rotate() );
+	QCOMPARE( model.objectList().size(), 2 );
+	QCOMPARE( model.objectList().at(0), object2 ); // Kept, not copied
+	QCOMPARE( model.objectList().at(1), object3 ); // Adopted
+	QCOMPARE( object3->parent(), &model );
+
+	model.clearModified();
+	object3->setX0( 5 ); // Connected
+	QVERIFY( model.isModified() );
+
+	delete saved;
+}
+
+
+void TestModel::objectAt()
+{
+	ColorNode black( Qt::black );
+
+	Model model;
+
+	// 10x10 grid of filled boxes, plus one box on top spanning the first row
+	QList<ModelObject*> boxes;
+	for ( int iy = 0; iy < 10; iy++ )
+	{
+		for ( int ix = 0; ix < 10; ix++ )
+		{
+			ModelObject* box = new ModelBoxObject( 20*ix, 20*iy, 10, 10, false, 1, black, black );
+			model.addObject( box );
+			boxes << box;
+		}
+	}
+	ModelObject* top = new ModelBoxObject( 0, 0, 200, 10, false, 1, black, black );
+	model.addObject( top );
+
+	QCOMPARE( model.objectAt( 1, 45, 65 ), boxes[3*10 + 2] );
+	QCOMPARE( model.objectAt( 1, 25, 5 ), top );
+	QVERIFY( !model.objectAt( 1, 55, 65 ) ); // Between boxes
+	QVERIFY( !model.objectAt( 1, 500, 500 ) ); // Outside all boxes
+
+	// Index follows moves
+	boxes[0]->setPosition( 300, 300 );
+	QCOMPARE( model.objectAt( 1, 305, 305 ), boxes[0] );
+	QCOMPARE( model.objectAt( 1, 5, 25 ), boxes[10] );
+
+	// Region selection
+	model.selectRegion( Region( 15, 15, 55, 55 ) );
+	QCOMPARE( model.getSelection().size(), 4 );
+	QVERIFY( boxes[11]->isSelected() );
+	QVERIFY( boxes[22]->isSelected() );
+	QVERIFY( !boxes[0]->isSelected() );
+}
@@ -29,4 +29,6 @@ private slots:
 	void initTestCase();
 	void model();
 	void saveRestore();
+	void restoreObjects();
+	void objectAt();
 };
@@ -38,6 +38,39 @@ using namespace glabels::model;
 using namespace glabels::merge;
 
 
+namespace
+{
+	///
+	/// Exposes shadow image creation for testing
+	///
+	class ShadowImageObject : public ModelImageObject
+	{
+	public:
+		using ModelImageObject::createShadowImage;
+	};
+
+
+	///
+	/// Check shadow against scalar formula: shadow color, with alpha scaled by source alpha
+	///
+	void verifyShadowImage( const QImage& image, const QColor& color )
+	{
+		ShadowImageObject object;
+		QImage shadow = object.createShadowImage( image, color );
+
+		QCOMPARE( shadow.size(), image.size() );
+		for ( int iy = 0; iy < image.height(); iy++ )
+		{
+			for ( int ix = 0; ix < image.width(); ix++ )
+			{
+				int alpha = ( color.alpha() * qAlpha( image.pixel( ix, iy ) ) ) / 255;
+				QCOMPARE( shadow.pixel( ix, iy ), (color.rgb() & RGB_MASK) | (QRgb( alpha ) << 24) );
+			}
+		}
+	}
+}
+
+
 void TestModelImageObject::initTestCase()
 {
 	Factory::init();
@@ -250,3 +283,80 @@ void TestModelImageObject::readImageFile()
 	delete model.merge();
 	delete model.variables();
 }
+
+
+void TestModelImageObject::imageData()
+{
+	QByteArray pngArray = QByteArray::fromBase64( glabels::test::blue_8x8_png );
+	QTemporaryFile pngFile; pngFile.open(); pngFile.write( pngArray ); pngFile.close();
+
+	// PNG source kept when read from file
+	ModelImageObject object( 0, 0, 8, 8, false, TextNode( false, pngFile.fileName() ) );
+	QVERIFY( object.image() != nullptr );
+	QCOMPARE( object.imageData(), pngArray );
+
+	// Kept by copies
+	ModelImageObject* copy = object.clone();
+	QCOMPARE( copy->imageData(), pngArray );
+	delete copy;
+
+	// Dropped when image is replaced
+	QImage png;
+	QVERIFY( png.loadFromData( QByteArray::fromBase64( glabels::test::green_8x8_png ), "PNG" ) );
+	object.setImage( "green.png", png );
+	QVERIFY( object.imageData().isEmpty() );
+
+	// Set explicitly, e.g. from <Data> node
+	QByteArray greenArray = QByteArray::fromBase64( glabels::test::green_8x8_png );
+	object.setImageData( greenArray );
+	QCOMPARE( object.imageData(), greenArray );
+
+	// Non-PNG source not kept
+	QTemporaryFile bmpFile; bmpFile.open(); bmpFile.close(); png.save( bmpFile.fileName(), "BMP" );
+	object.setFilenameNode( TextNode( false, bmpFile.fileName() ) );
+	QVERIFY( object.image() != nullptr );
+	QVERIFY( object.imageData().isEmpty() );
+}
+
+
+void TestModelImageObject::createShadowImage()
+{
+	// Odd widths exercise vectorized and leftover pixels of each scan line
+	QColor color( 10, 20, 30, 200 );
+
+	///
+	/// Indexed8 source, alpha from color table
+	///
+	QImage indexed( 37, 5, QImage::Format_Indexed8 );
+	QVector<QRgb> colorTable;
+	for ( int i = 0; i < 256; i++ )
+	{
+		colorTable << qRgba( i, 255 - i, i/2, i );
+	}
+	indexed.setColorTable( colorTable );
+	for ( int iy = 0; iy < indexed.height(); iy++ )
+	{
+		for ( int ix = 0; ix < indexed.width(); ix++ )
+		{
+			indexed.setPixel( ix, iy, (ix*7 + iy*31) % 256 );
+		}
+	}
+	verifyShadowImage( indexed, color );
+
+	///
+	/// ARGB32_Premultiplied source
+	///
+	QImage premultiplied( 23, 3, QImage::Format_ARGB32_Premultiplied );
+	for ( int iy = 0; iy < premultiplied.height(); iy++ )
+	{
+		for ( int ix = 0; ix < premultiplied.width(); ix++ )
+		{
+			int alpha = (ix*11 + iy*97) % 256;
+			premultiplied.setPixel( ix, iy, qPremultiply( qRgba( 255, 128, 0, alpha ) ) );
+		}
+	}
+	verifyShadowImage( premultiplied, color );
+
+	// Opaque shadow color keeps source alpha
+	verifyShadowImage( premultiplied, QColor( 0, 0, 0 ) );
+}
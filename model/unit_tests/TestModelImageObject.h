@@ -28,4 +28,6 @@ class TestModelImageObject : public QObject
 private slots:
 	void initTestCase();
 	void readImageFile();
+	void imageData();
+	void createShadowImage();
 };
@@ -0,0 +1,194 @@
+/*  TestPageRenderer.cpp
+ *
+ *  Copyright (C) 2019  Jim Evins <evins@snaught.com>
+ *
+ *  This file is part of gLabels-qt.
+ *
+ *  gLabels-qt is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  gLabels-qt is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with gLabels-qt.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestPageRenderer.h"
+
+#include "model/FrameRect.h"
+#include "model/Layout.h"
+#include "model/Model.h"
+#include "model/ModelBoxObject.h"
+#include "model/PageRenderer.h"
+
+#include "merge/Factory.h"
+#include "merge/Merge.h"
+#include "merge/TextCsvKeys.h"
+
+#include <QPaintEngine>
+#include <QPrinter>
+#include <QtDebug>
+
+
+QTEST_MAIN(TestPageRenderer)
+
+using namespace glabels::model;
+using namespace glabels::merge;
+
+
+namespace
+{
+
+	///
+	/// Paint engine recording the fill color of each shape drawn
+	///
+	class FillRecordingEngine : public QPaintEngine
+	{
+	public:
+		FillRecordingEngine() : QPaintEngine( QPaintEngine::AllFeatures ) { }
+
+		bool begin( QPaintDevice* ) override { return true; }
+		bool end() override { return true; }
+		Type type() const override { return QPaintEngine::User; }
+
+		void updateState( const QPaintEngineState& state ) override
+		{
+			if ( state.state() & QPaintEngine::DirtyBrush )
+			{
+				mBrush = state.brush();
+			}
+		}
+
+		void drawRects( const QRectF*, int rectCount ) override
+		{
+			for ( int i = 0; i < rectCount; i++ )
+			{
+				recordFill();
+			}
+		}
+
+		void drawPath( const QPainterPath& ) override { recordFill(); }
+		void drawPolygon( const QPointF*, int, PolygonDrawMode ) override { recordFill(); }
+		void drawPixmap( const QRectF&, const QPixmap&, const QRectF& ) override { }
+
+		QStringList fills;
+
+	private:
+		void recordFill()
+		{
+			if ( mBrush.style() != Qt::NoBrush )
+			{
+				fills << mBrush.color().name();
+			}
+		}
+
+		QBrush mBrush;
+	};
+
+
+	///
+	/// Printer recording fill colors, one list per page
+	///
+	class RecordingPrinter : public QPrinter
+	{
+	public:
+		RecordingPrinter()
+		{
+			setOutputFileName( QDir::tempPath().append( "/TestPageRenderer.pdf" ) ); // Never written
+		}
+
+		QPaintEngine* paintEngine() const override
+		{
+			return &mEngine;
+		}
+
+		bool newPage() override
+		{
+			pages << mEngine.fills;
+			mEngine.fills.clear();
+			return true;
+		}
+
+		QList<QStringList> allPages()
+		{
+			return pages + QList<QStringList>{ mEngine.fills };
+		}
+
+		QList<QStringList> pages;
+
+	private:
+		mutable FillRecordingEngine mEngine;
+	};
+
+}
+
+
+void TestPageRenderer::initTestCase()
+{
+	Factory::init();
+}
+
+
+void TestPageRenderer::printJobs()
+{
+	Model model;
+
+	// Two labels per page
+	Template tmplate( "Test Brand", "part", "desc", "testPaperId", 100, 100 );
+	FrameRect* frame = new FrameRect( 100, 50, 0, 0, 0, "rect1" );
+	frame->addLayout( Layout( 1, 2, 0, 0, 0, 50 ) );
+	tmplate.addFrame( frame );
+	model.setTmplate( &tmplate ); // Copies
+
+	// Box filled with color of record
+	model.addObject( new ModelBoxObject( 10, 10, 20, 20, false, 0,
+	                                     ColorNode( Qt::transparent ),
+	                                     ColorNode( true, QColor(), "color" ) ) );
+
+	QTemporaryFile csv;
+	csv.open();
+	csv.write( "id,color\n" );
+	QStringList expectedFills;
+	for ( int i = 1; i <= 7; i++ )
+	{
+		QString color = QColor( i, 2*i, 3*i ).name();
+		csv.write( QString( "%1,%2\n" ).arg( i ).arg( color ).toUtf8() );
+		expectedFills << color;
+	}
+	csv.close();
+
+	Merge* merge = Factory::createMerge( TextCsvKeys::id() );
+	QVERIFY( merge );
+	merge->setSource( csv.fileName() );
+	model.setMerge( merge );
+	QCOMPARE( merge->nSelectedRecords(), 7 );
+
+	PageRenderer renderer( &model );
+	renderer.setNCopies( 1 );
+	QCOMPARE( renderer.nPages(), 4 );
+
+	QList<QStringList> expectedPages;
+	for ( int iPage = 0; iPage < 4; iPage++ )
+	{
+		expectedPages << expectedFills.mid( 2*iPage, 2 );
+	}
+
+	///
+	/// Single thread
+	///
+	RecordingPrinter printer1;
+	renderer.print( &printer1, 1 );
+	QCOMPARE( printer1.allPages(), expectedPages );
+
+	///
+	/// Worker threads, pages in same order
+	///
+	RecordingPrinter printer3;
+	renderer.print( &printer3, 3 );
+	QCOMPARE( printer3.allPages(), expectedPages );
+}
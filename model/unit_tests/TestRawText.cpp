@@ -91,4 +91,25 @@ void TestRawText::rawText()
 	rawText = "${key2}${key3}${key1}";
 	QVERIFY( rawText.hasPlaceHolders() );
 	QCOMPARE( rawText.expand( &record, nullptr ), QString( "val2val1" ) );
+
+	///
+	/// Records from different sources (field bindings are refreshed)
+	///
+	Record record2;
+	record2["key3"] = "val3";
+	record2["key1"] = "val1b";
+	QCOMPARE( rawText.expand( &record2, nullptr ), QString( "val3val1b" ) );
+	QCOMPARE( rawText.expand( &record, nullptr ), QString( "val2val1" ) );
+	record["key3"] = "val3";
+	QCOMPARE( rawText.expand( &record, nullptr ), QString( "val2val3val1" ) );
+
+	RawText rawText3 = rawText;
+	QCOMPARE( rawText3.expand( &record2, nullptr ), QString( "val3val1b" ) );
+	QCOMPARE( rawText.expand( &record, nullptr ), QString( "val2val3val1" ) );
+	QCOMPARE( rawText3.expand( nullptr, nullptr ), QString( "" ) );
+
+	rawText = "${key1:%08.3f}/${key2:%-4s}|";
+	record["key1"] = "3.14159";
+	record["key2"] = "ab";
+	QCOMPARE( rawText.expand( &record, nullptr ), QString( "0003.142/ab  |" ) );
 }
@@ -122,3 +122,23 @@ void TestTextNode::textNode()
 	///
 	QCOMPARE( textNode.text( &record, &vars ), QString( "val1" ) );
 }
+
+
+void TestTextNode::rebindKey()
+{
+	Record record;
+	record["key1"] = "val1";
+	record["key2"] = "val2";
+
+	TextNode textNode( true, "key1" );
+	QCOMPARE( textNode.text( &record, nullptr ), QString( "val1" ) );
+
+	// Copy of a node bound to "key1", rebound against the same record
+	TextNode copy = textNode;
+	copy.setData( "key2" );
+	QCOMPARE( copy.text( &record, nullptr ), QString( "val2" ) );
+	QCOMPARE( textNode.text( &record, nullptr ), QString( "val1" ) );
+
+	textNode.setData( "key2" );
+	QCOMPARE( textNode.text( &record, nullptr ), QString( "val2" ) );
+}
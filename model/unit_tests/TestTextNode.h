@@ -27,4 +27,5 @@ class TestTextNode : public QObject
 
 private slots:
 	void textNode();
+	void rebindKey();
 };
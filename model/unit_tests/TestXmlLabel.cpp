@@ -486,6 +486,53 @@ void TestXmlLabel::writeReadFile()
 }
 
 
+void TestXmlLabel::writeReadCompressedFile()
+{
+	Model* model = new Model();
+
+	QTemporaryFile glabels( QDir::tempPath().append( "/TestXmlLabel_XXXXXX.glabels" ) );
+	glabels.open(); glabels.close();
+
+	QByteArray pngArray = QByteArray::fromBase64( glabels::test::blue_8x8_png );
+	QImage png;
+	QVERIFY( png.loadFromData( pngArray, "PNG" ) );
+
+	Template tmplate( "Test Brand", "part", "desc", "testPaperId", 110, 410 );
+	tmplate.addFrame( new FrameRect( 120, 220, 5, 0, 0, "rect1" ) );
+	model->setTmplate( &tmplate ); // Copies
+
+	model->addObject( new ModelBoxObject( 0, 1, 10, 20, false, 2, ColorNode( Qt::red ), ColorNode( Qt::green ) ) );
+	model->addObject( new ModelImageObject( 3, 4, 60, 70, false, "image.png", png ) );
+
+	///
+	/// Write compressed and read
+	///
+	XmlLabelCreator::writeFile( model, glabels.fileName(), 9 );
+
+	QFile file( glabels.fileName() );
+	QVERIFY( file.open( QFile::ReadOnly ) );
+	QByteArray magic = file.read( 2 );
+	file.close();
+
+#if HAVE_ZLIB
+	QCOMPARE( magic, QByteArray( "\x1F\x8B" ) ); // gzip magic number
+#else
+	QCOMPARE( magic, QByteArray( "<?" ) );
+#endif
+
+	Model* readModel = XmlLabelParser::readFile( glabels.fileName() );
+	QVERIFY( readModel );
+	QCOMPARE( readModel->tmplate()->brand(), model->tmplate()->brand() );
+	QCOMPARE( readModel->objectList().size(), 2 );
+	QVERIFY( dynamic_cast<ModelBoxObject*>( readModel->objectList()[0] ) );
+	QVERIFY( readModel->objectList()[1]->image() );
+	QCOMPARE( *readModel->objectList()[1]->image(), png );
+
+	delete readModel;
+	delete model;
+}
+
+
 void TestXmlLabel::parser_3ReadFile()
 {
 	// Current path is "build/model/unit_tests" so go up 3 levels
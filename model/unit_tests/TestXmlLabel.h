@@ -29,6 +29,7 @@ private slots:
 	void initTestCase();
 	void serializeDeserialize();
 	void writeReadFile();
+	void writeReadCompressedFile();
 	void parser_3ReadFile();
 	void parser_3Barcode();
 };
@@ -296,3 +296,43 @@ void TestXmlUtil::getWrapModeAttr()
 	QCOMPARE( XmlUtil::getWrapModeAttr( node, "e", QTextOption::NoWrap ),       QTextOption::NoWrap );
 	QCOMPARE( XmlUtil::getWrapModeAttr( node, "e", QTextOption::WrapAnywhere ), QTextOption::WrapAnywhere );
 }
+
+
+void TestXmlUtil::readElement()
+{
+	using namespace glabels::model;
+
+	// Test XML
+	QString xml = "<root><!-- c --><skip/><elem a='1' b='x'>\n  <p>Line 1</p>\n  <p> Line 2 </p></elem><next/></root>";
+
+	QXmlStreamReader reader( xml );
+	reader.setNamespaceProcessing( false );
+	QVERIFY( reader.readNextStartElement() );
+	QVERIFY( reader.readNextStartElement() );
+	QCOMPARE( reader.qualifiedName().toString(), QString("skip") );
+	reader.skipCurrentElement();
+	QVERIFY( reader.readNextStartElement() );
+
+	//
+	// Tests
+	//
+	QDomDocument doc;
+	QDomElement node = XmlUtil::readElement( reader, doc );
+	QCOMPARE( node.tagName(), QString("elem") );
+	QCOMPARE( XmlUtil::getStringAttr( node, "a", "" ), QString("1") );
+	QCOMPARE( XmlUtil::getStringAttr( node, "b", "" ), QString("x") );
+
+	// Whitespace-only text dropped, as with QDomDocument::setContent()
+	QCOMPARE( node.childNodes().count(), 2 );
+	QCOMPARE( node.firstChildElement( "p" ).text(), QString("Line 1") );
+	QCOMPARE( node.lastChildElement( "p" ).text(), QString(" Line 2 ") );
+
+	// Reader left at end of element
+	QVERIFY( reader.isEndElement() );
+	QCOMPARE( reader.qualifiedName().toString(), QString("elem") );
+	QVERIFY( reader.readNextStartElement() );
+	QCOMPARE( reader.qualifiedName().toString(), QString("next") );
+
+	// Attributes from a stream reader
+	QCOMPARE( XmlUtil::getStringAttr( reader.attributes(), "a", "default" ), QString("default") );
+}
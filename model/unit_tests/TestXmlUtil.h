@@ -35,6 +35,7 @@ private slots:
 	void getWeightAttr();
 	void getAlignmentAttr();
 	void getWrapModeAttr();
+	void readElement();
 
 	// TODO: test setters
 };